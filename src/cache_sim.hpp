@@ -0,0 +1,195 @@
+#ifndef CACHE_SIM_HPP
+#define CACHE_SIM_HPP
+
+#include <cstdint>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <libfqfft/tools/exceptions.hpp>
+
+/*
+ * Set-associative, write-back, write-allocate caches with LRU replacement,
+ * stacked into a hierarchy whose last level is shared and whose other levels
+ * are private to each thread. A demand access that misses a level is looked
+ * up in the next one; a dirty victim is written back one level down, where
+ * it allocates without a fetch. Only what leaves the last level (line fills
+ * and writebacks) reaches the memory callback, so that is the traffic DRAM
+ * sees. Dirty lines still cached at the end are not flushed. Coherence is
+ * not modelled: the NTT threads write disjoint lines.
+ */
+
+struct cache_level_config
+{
+    std::string name;
+    size_t size;    // bytes
+    size_t ways;
+};
+
+struct cache_level_stats
+{
+    size_t reads = 0;
+    size_t writes = 0;
+    size_t hits = 0;
+    size_t writebacks_in = 0;   // dirty lines received from the level above
+    size_t writebacks_out = 0;  // dirty lines evicted to the level below
+};
+
+class cache_level
+{
+public:
+    cache_level_stats stats;
+
+    cache_level(const cache_level_config& config, const size_t line)
+        : sets(config.size / (line * config.ways)), ways(config.ways),
+          tags(sets * ways, 0), stamps(sets * ways, 0), valid(sets * ways, false), dirty(sets * ways, false)
+    {
+        if (sets == 0 || (sets & (sets - 1)) != 0)
+            throw libfqfft::InvalidSizeException("cache_level(): expected size / (line * ways) to be a power of two");
+    }
+
+    /*
+     * Looks up line number `l`; on a miss the LRU way is replaced. A writeback
+     * allocates and marks dirty without counting as a demand access. Returns
+     * whether it hit; `evicted` is set when a dirty victim must go down.
+     */
+    bool access(const uint64_t l, const bool write, const bool writeback, bool& evicted, uint64_t& victim)
+    {
+        const size_t set = l & (sets - 1);
+        const size_t first = set * ways;
+        evicted = false;
+        ++clock;
+        if (writeback) ++stats.writebacks_in;
+        else if (write) ++stats.writes;
+        else ++stats.reads;
+
+        size_t lru = first;
+        for (size_t w = first; w < first + ways; ++w) {
+            if (valid[w] && tags[w] == l) {
+                stamps[w] = clock;
+                dirty[w] = dirty[w] || write;
+                if (!writeback) ++stats.hits;
+                return true;
+            }
+            if (!valid[lru]) continue;
+            if (!valid[w] || stamps[w] < stamps[lru]) lru = w;
+        }
+
+        if (valid[lru] && dirty[lru]) {
+            evicted = true;
+            victim = tags[lru];
+            ++stats.writebacks_out;
+        }
+        tags[lru] = l;
+        stamps[lru] = clock;
+        valid[lru] = true;
+        dirty[lru] = write;
+        return false;
+    }
+
+private:
+    size_t sets;
+    size_t ways;
+    uint64_t clock = 0;
+    std::vector<uint64_t> tags;
+    std::vector<uint64_t> stamps;
+    std::vector<bool> valid;
+    std::vector<bool> dirty;
+};
+
+class cache_hierarchy
+{
+public:
+    cache_hierarchy(const std::vector<cache_level_config>& configs, const size_t line, const size_t threads)
+        : configs(configs), line(line), threads(threads)
+    {
+        if (configs.empty()) throw libfqfft::InvalidSizeException("cache_hierarchy(): expected at least one level");
+        for (size_t i = 0; i + 1 < configs.size(); ++i)
+            for (size_t t = 0; t < threads; ++t) levels.emplace_back(configs[i], line);
+        levels.emplace_back(configs.back(), line);
+    }
+
+    size_t line_size() const { return line; }
+    size_t depth() const { return configs.size(); }
+    const cache_level_config& config(const size_t i) const { return configs[i]; }
+
+    /* Level i summed over the threads that have a copy of it */
+    cache_level_stats stats(const size_t i) const
+    {
+        cache_level_stats s;
+        const size_t copies = (i + 1 < configs.size()) ? threads : 1;
+        for (size_t t = 0; t < copies; ++t) {
+            const cache_level_stats& c = levels[index(i, t)].stats;
+            s.reads += c.reads;
+            s.writes += c.writes;
+            s.hits += c.hits;
+            s.writebacks_in += c.writebacks_in;
+            s.writebacks_out += c.writebacks_out;
+        }
+        return s;
+    }
+
+    /* One access by thread t to the line holding byte address addr; memory(addr, write) receives the last level's traffic */
+    template<typename Memory>
+    void access(const size_t t, const uint64_t addr, const bool write, Memory& memory)
+    {
+        lookup(0, t, addr / line, write, false, memory);
+    }
+
+private:
+    std::vector<cache_level_config> configs;
+    size_t line;
+    size_t threads;
+    std::vector<cache_level> levels;
+
+    size_t index(const size_t i, const size_t t) const
+    {
+        return (i + 1 < configs.size()) ? i * threads + t : levels.size() - 1;
+    }
+
+    template<typename Memory>
+    void lookup(const size_t i, const size_t t, const uint64_t l, const bool write, const bool writeback, Memory& memory)
+    {
+        if (i == configs.size()) {
+            memory(l * line, write);
+            return;
+        }
+        bool evicted;
+        uint64_t victim;
+        const bool hit = levels[index(i, t)].access(l, write, writeback, evicted, victim);
+        if (evicted) lookup(i + 1, t, victim, true, true, memory);
+        if (!hit && !writeback) lookup(i + 1, t, l, false, false, memory);
+    }
+};
+
+/* "L1:32K:8,L2:1M:16,LLC:32M:16" : name, size (K / M / G suffix) and ways of each level, top first */
+inline bool parse_cache_levels(const std::string& spec, std::vector<cache_level_config>& configs)
+{
+    configs.clear();
+    std::istringstream levels(spec);
+    std::string level;
+    while (std::getline(levels, level, ',')) {
+        std::istringstream fields(level);
+        std::string name, size, ways;
+        if (!std::getline(fields, name, ':') || !std::getline(fields, size, ':') || !std::getline(fields, ways, ':')) return false;
+        if (size.empty() || ways.empty()) return false;
+
+        size_t bytes;
+        size_t end;
+        try {
+            bytes = std::stoul(size, &end);
+            const std::string unit = size.substr(end);
+            if (unit == "K" || unit == "k") bytes <<= 10;
+            else if (unit == "M" || unit == "m") bytes <<= 20;
+            else if (unit == "G" || unit == "g") bytes <<= 30;
+            else if (!unit.empty()) return false;
+            configs.push_back({name, bytes, std::stoul(ways)});
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    return !configs.empty();
+}
+
+#endif // CACHE_SIM_HPP
@@ -0,0 +1,113 @@
+#include "utils.hpp"
+#include "polynomial_division.hpp"
+
+/* Divide a 2^(k+1) polynomial by a 2^k one both ways; returns the two times in us (schoolbook -1 when skipped) */
+std::pair<long, long> test(int k, const bool schoolbook, const ntt_engine engine, const bool multicore)
+{
+    const size_t degree = 1ul << k;
+
+    std::vector<FieldT> a(2 * degree);
+    std::vector<FieldT> b(degree);
+    for (auto& x : a) x = FieldT::random_element();
+    for (auto& x : b) x = FieldT::random_element();
+
+    std::vector<FieldT> q1, r1, q2, r2;
+    long schoolbook_us = -1;
+    long newton_us;
+
+    // Schoolbook Timing Measure
+    if (schoolbook) {
+    std::cout << "[*] processing Schoolbook Division";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    _polynomial_division(q1, r1, a, b);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+    schoolbook_us = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Schoolbook Division process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    // Newton Timing Measure
+    {
+    std::cout << "[*] processing Newton Division";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    polynomial_division_newton(q2, r2, a, b, engine, multicore);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+    newton_us = std::chrono::duration_cast<std::chrono::microseconds>(end_time - start_time).count();
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Newton Division process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    _condense(r1);
+    if (schoolbook && (q1 != q2 || r1 != r2)) std::cout << "Schoolbook and Newton Results are different" << std::endl;
+
+    return std::make_pair(schoolbook_us, newton_us);
+}
+
+int main(int argc, char* argv[]) {
+    int opt;
+    std::vector<int> sizes;
+    int schoolbook_max = 14;
+    bool multicore = false;
+    ntt_engine engine = ntt_engine::libfqfft;
+
+    while ((opt = getopt(argc, argv, "n:s:me:")) != -1) {
+        switch (opt) {
+            case 'n':
+                sizes.push_back(std::stoi(optarg));
+                break;
+            case 's':
+                schoolbook_max = std::stoi(optarg);
+                break;
+            case 'm':
+                multicore = true;
+                break;
+            case 'e':
+                if (parse_ntt_engine(optarg, engine)) break;
+                std::cerr << "[-] Unknown engine " << optarg << " (libfqfft|stockham|radix2)" << std::endl;
+                return 1;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-m] [-e libfqfft|stockham|radix2] [-s k] [-n k]..." << std::endl;
+                return 1;
+        }
+    }
+
+    if (sizes.empty()) sizes = {4, 5, 6, 7, 8, 9, 10, 12, 14, 16};
+
+    bls12_381_pp::init_public_params();
+    std::cout << "[i] Mode : " << (multicore ? "Parallel" : "Serial") << std::endl;
+    std::cout << "\t- engine : " << ntt_engine_name(engine) << std::endl;
+
+    std::vector<std::pair<long, long> > times;
+    for (int i : sizes) {
+        std::cout << "# Test " << i << std::endl;
+        times.push_back(test(i, i <= schoolbook_max, engine, multicore));
+        std::cout << std::endl;
+    }
+
+    std::cout << "[i] Division 2^(k+1) / 2^k (us)" << std::endl;
+    int crossover = -1;
+    for (size_t i = 0; i < sizes.size(); ++i) {
+        std::cout << "\t - k = " << sizes[i] << " : schoolbook ";
+        if (times[i].first < 0) std::cout << "-";
+        else std::cout << times[i].first;
+        std::cout << ", newton " << times[i].second << std::endl;
+        if (crossover < 0 && times[i].first >= 0 && times[i].second < times[i].first) crossover = sizes[i];
+    }
+    if (crossover >= 0) std::cout << "\t - Crossover : 2^" << crossover << std::endl;
+
+    return 0;
+}
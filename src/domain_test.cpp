@@ -0,0 +1,103 @@
+#include "utils.hpp"
+#include "ntt_domain.hpp"
+
+/* FFT, iFFT, cosetFFT, icosetFFT of a 2^k vector through get_evaluation_domain and get_ntt_evaluation_domain */
+int test(int k, const ntt_engine engine, const bool multicore)
+{
+    const size_t m = 1ul << k;
+    const FieldT g = FieldT::multiplicative_generator;
+
+    std::vector<FieldT> a(m);
+    for (auto& x : a) x = FieldT::random_element();
+
+    std::shared_ptr<evaluation_domain<FieldT> > base = get_evaluation_domain<FieldT>(m);
+    std::shared_ptr<evaluation_domain<FieldT> > fast = get_ntt_evaluation_domain<FieldT>(m, engine, multicore);
+
+    std::vector<FieldT> u[4];
+    std::vector<FieldT> v[4];
+
+    // libfqfft Domain Timing Measure
+    {
+    std::cout << "[*] processing libfqfft Domain";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    u[0] = a; base->FFT(u[0]);
+    u[1] = a; base->iFFT(u[1]);
+    u[2] = a; base->cosetFFT(u[2], g);
+    u[3] = a; base->icosetFFT(u[3], g);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] libfqfft Domain process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    // NTT Domain Timing Measure
+    {
+    std::cout << "[*] processing NTT Domain";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    v[0] = a; fast->FFT(v[0]);
+    v[1] = a; fast->iFFT(v[1]);
+    v[2] = a; fast->cosetFFT(v[2], g);
+    v[3] = a; fast->icosetFFT(v[3], g);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] NTT Domain process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    const char* names[4] = { "FFT", "iFFT", "cosetFFT", "icosetFFT" };
+    for (size_t i = 0; i < 4; ++i)
+        if (u[i] != v[i]) std::cout << names[i] << " Results are different" << std::endl;
+
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int opt;
+    std::vector<int> sizes;
+    bool multicore = false;
+    ntt_engine engine = ntt_engine::radix2;
+
+    while ((opt = getopt(argc, argv, "n:me:")) != -1) {
+        switch (opt) {
+            case 'n':
+                sizes.push_back(std::stoi(optarg));
+                break;
+            case 'm':
+                multicore = true;
+                break;
+            case 'e':
+                if (parse_ntt_engine(optarg, engine)) break;
+                std::cerr << "[-] Unknown engine " << optarg << " (libfqfft|stockham|radix2)" << std::endl;
+                return 1;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-m] [-e libfqfft|stockham|radix2] [-n k]..." << std::endl;
+                return 1;
+        }
+    }
+
+    if (sizes.empty()) sizes = {16, 18, 20};
+
+    bls12_381_pp::init_public_params();
+    std::cout << "[i] Mode : " << (multicore ? "Parallel" : "Serial") << std::endl;
+    std::cout << "\t- engine : " << ntt_engine_name(engine) << std::endl;
+
+    for (int i : sizes) {
+        std::cout << "# Test " << i << std::endl;
+        test(i, engine, multicore);
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,51 @@
+#ifndef DRAMSIM_TRACE_HPP
+#define DRAMSIM_TRACE_HPP
+
+#include <cstdint>
+#include <iomanip>
+#include <ostream>
+
+/*
+ * Writer of DRAMSim3 traces (test/DRAMSim/example.trace): one
+ * "0xADDR READ|WRITE cycle" line per transaction, stamped with the writer's
+ * clock, which the producer advances. Transactions can be limited to a
+ * window and sampled one in k (the clock still counts the skipped ones);
+ * cycles start from 0 at the first transaction written.
+ */
+class dramsim_trace_writer
+{
+public:
+    size_t sample = 1;
+    size_t window_begin = 0;
+    size_t window_count = 0;    // 0: to the end
+
+    explicit dramsim_trace_writer(std::ostream& out) : out(out) {}
+
+    void tick(const uint64_t cycles) { cycle += cycles; }
+
+    void transaction(const uint64_t addr, const bool write)
+    {
+        const size_t index = seen++;
+        if (index < window_begin || (window_count && index >= window_begin + window_count)) return;
+        if ((index - window_begin) % sample != 0) return;
+
+        if (written_total == 0) first_cycle = cycle;
+        out << "0x" << std::hex << std::uppercase << std::setw(8) << std::setfill('0') << addr << std::dec << std::nouppercase
+            << std::setfill(' ') << (write ? " WRITE " : " READ  ") << cycle - first_cycle << "\n";
+        ++written_total;
+    }
+
+    /* Past the end of the window: the producer can stop */
+    bool done() const { return window_count && seen >= window_begin + window_count; }
+
+    size_t written() const { return written_total; }
+
+private:
+    std::ostream& out;
+    uint64_t cycle = 0;
+    uint64_t first_cycle = 0;
+    size_t seen = 0;
+    size_t written_total = 0;
+};
+
+#endif // DRAMSIM_TRACE_HPP
@@ -0,0 +1,139 @@
+#include "utils.hpp"
+#include "polynomial_expression.hpp"
+
+/* (a*b + c)*d - e, one coefficient-form call per operation; the libfqfft add and subtract count one pass each */
+template <typename FieldT>
+void naive_expression(const std::vector<FieldT>& a, const std::vector<FieldT>& b, const std::vector<FieldT>& c,
+                      const std::vector<FieldT>& d, const std::vector<FieldT>& e, std::vector<FieldT>& r,
+                      const ntt_engine engine, const bool multicore)
+{
+    std::vector<FieldT> t;
+    std::vector<FieldT> s;
+
+    if (multicore) polynomial_multiplication_on_FFT_parallel(a, b, t, convolution_kind::linear, engine);
+    else polynomial_multiplication_on_FFT_serial(a, b, t, convolution_kind::linear, engine);
+    _polynomial_addition(s, t, c);
+    ntt_count_pass();
+    if (multicore) polynomial_multiplication_on_FFT_parallel(s, d, t, convolution_kind::linear, engine);
+    else polynomial_multiplication_on_FFT_serial(s, d, t, convolution_kind::linear, engine);
+    _polynomial_subtraction(r, t, e);
+    ntt_count_pass();
+}
+
+int test(int k, const ntt_engine engine, const bool multicore)
+{
+    /* Inputs of 2^(k-2) coefficients; the result has 3 * 2^(k-2) - 2, so both products fit one 3 * 2^(k-2) domain */
+    const size_t degree = 1ul << (k - 2);
+
+    std::vector<FieldT> a(degree);
+    std::vector<FieldT> b(degree);
+    std::vector<FieldT> c(degree);
+    std::vector<FieldT> d(degree);
+    std::vector<FieldT> e(degree);
+    for (auto* p : {&a, &b, &c, &d, &e})
+        for (auto& x : *p) x = FieldT::random_element();
+
+    std::vector<FieldT> naive;
+    std::vector<FieldT> lazy;
+    expression_stats stats;
+    ntt_work_counts naive_work;
+    ntt_work_counts lazy_work;
+    size_t n;
+
+    // Naive Timing Measure
+    {
+    std::cout << "[*] processing Naive Expression";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    const ntt_work_counts naive_start = ntt_read_work_counts();
+    naive_expression(a, b, c, d, e, naive, engine, multicore);
+    naive_work = ntt_read_work_counts() - naive_start;
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Naive Expression process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    // Lazy Timing Measure
+    {
+    std::cout << "[*] processing Lazy Expression";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    const ntt_work_counts lazy_start = ntt_read_work_counts();
+    expression_context<FieldT> ctx(3 * degree - 2, engine, multicore);
+    auto A = ctx.input(a), B = ctx.input(b), C = ctx.input(c), D = ctx.input(d), E = ctx.input(e);
+    ctx.materialize((A * B + C) * D - E, lazy);
+    lazy_work = ntt_read_work_counts() - lazy_start;
+    stats = ctx.stats();
+    n = ctx.domain_size();
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Lazy Expression process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    /* Measured: kernel transforms (a 3 * 2^k size runs three), their length in domains of n, and full-array passes */
+    std::cout << "[i] Work" << std::endl;
+    std::cout << "\t - Domain : " << n << std::endl;
+    std::cout << std::fixed << std::setprecision(2);
+    std::cout << "\t - Naive : NTT " << naive_work.transforms << " (" << double(naive_work.elements) / n << " x n), passes "
+              << naive_work.passes << std::endl;
+    std::cout << "\t - Lazy : NTT " << lazy_work.transforms << " (" << double(lazy_work.elements) / n << " x n; "
+              << stats.forward_ntts << " forward, " << stats.inverse_ntts << " inverse domain transforms), passes "
+              << lazy_work.passes << std::endl;
+    std::cout << std::defaultfloat;
+
+    if (naive != lazy) std::cout << "Naive and Lazy Results are different" << std::endl;
+
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int opt;
+    std::vector<int> sizes;
+    bool multicore = false;
+    ntt_engine engine = ntt_engine::libfqfft;
+
+    while ((opt = getopt(argc, argv, "n:me:")) != -1) {
+        switch (opt) {
+            case 'n':
+                sizes.push_back(std::stoi(optarg));
+                break;
+            case 'm':
+                multicore = true;
+                break;
+            case 'e':
+                if (parse_ntt_engine(optarg, engine)) break;
+                std::cerr << "[-] Unknown engine " << optarg << " (libfqfft|stockham|radix2)" << std::endl;
+                return 1;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-m] [-e libfqfft|stockham|radix2] [-n k]..." << std::endl;
+                return 1;
+        }
+    }
+
+    if (sizes.empty()) sizes = {16, 20};
+
+    bls12_381_pp::init_public_params();
+    std::cout << "[i] Mode : " << (multicore ? "Parallel" : "Serial") << std::endl;
+    std::cout << "\t- engine : " << ntt_engine_name(engine) << std::endl;
+
+    for (int i : sizes) {
+        if (i < 2) continue;
+        std::cout << "# Test " << i << std::endl;
+        test(i, engine, multicore);
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
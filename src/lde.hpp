@@ -0,0 +1,61 @@
+#ifndef LDE_HPP
+#define LDE_HPP
+
+#include "utils.hpp"
+#include "ntt.hpp"
+
+/*
+ * Low-degree extension: the k * n evaluations f(g * w^j), j < k * n, of a
+ * polynomial with at most n coefficients on the coset g<w>, w a primitive
+ * (k * n)-th root of unity.
+ *
+ * Zero-padding f to k * n and transforming would spend most of the work on
+ * zeros. Writing j = r + k * i splits the coset into k cosets of the size-n
+ * subgroup <w^k>, shifted by g * w^r, so the extension is k size-n transforms of
+ * f twisted by (g * w^r)^i. The twist rides on the copy-in, or on the first
+ * stage for the Stockham engine, and the radix-2 engine runs all k transforms
+ * as lanes of one pass. The result is scattered back to natural order.
+ */
+template <typename FieldT>
+void low_degree_extension(const std::vector<FieldT>& f, const size_t blowup, const FieldT& shift, std::vector<FieldT>& evaluations,
+                          const ntt_engine engine, const bool multicore)
+{
+    if (blowup == 0 || (blowup & (blowup - 1)) != 0) throw DomainSizeException("expected a power-of-two blowup");
+
+    const size_t n = libff::get_power_of_two(std::max<size_t>(f.size(), 1));
+    const size_t N = blowup * n;
+    const FieldT omega_N = libff::get_root_of_unity<FieldT>(N);
+    const FieldT omega_n = omega_N^blowup;
+
+    std::vector<std::vector<FieldT> > y(blowup);
+    std::vector<FieldT> work;
+    FieldT coset = shift;
+    for (size_t r = 0; r < blowup; ++r) {
+        const ntt_twist<FieldT> twist(FieldT::one(), coset);
+        if (engine == ntt_engine::stockham) {
+            if (multicore) twisted_copy_parallel(y[r], f, n, ntt_twist<FieldT>());
+            else twisted_copy_serial(y[r], f, n, ntt_twist<FieldT>());
+            if (multicore) stockham_parallel_ntt(y[r], work, omega_n, twist);
+            else stockham_serial_ntt(y[r], work, omega_n, twist);
+        } else {
+            if (multicore) twisted_copy_parallel(y[r], f, n, twist);
+            else twisted_copy_serial(y[r], f, n, twist);
+            if (engine == ntt_engine::libfqfft && multicore) _basic_parallel_radix2_FFT(y[r], omega_n);
+            else if (engine == ntt_engine::libfqfft) _basic_serial_radix2_FFT(y[r], omega_n);
+        }
+        coset *= omega_N;
+    }
+
+    if (engine == ntt_engine::radix2) {
+        std::vector<FieldT*> lanes(blowup);
+        for (size_t r = 0; r < blowup; ++r) lanes[r] = y[r].data();
+        radix2_ntt_lanes(lanes.data(), blowup, n, omega_n, multicore);
+    }
+
+    evaluations.resize(N);
+    #pragma omp parallel for if(multicore)
+    for (size_t i = 0; i < n; ++i)
+        for (size_t r = 0; r < blowup; ++r) evaluations[r + blowup * i] = y[r][i];
+}
+
+#endif // LDE_HPP
@@ -0,0 +1,105 @@
+#include "utils.hpp"
+#include "lde.hpp"
+
+/* Extend a 2^k polynomial to every requested blowup on the multiplicative-generator coset, against zero padding + _multiply_by_coset */
+int test(int k, const std::vector<size_t>& blowups, const ntt_engine engine, const bool multicore)
+{
+    const size_t n = 1ul << k;
+    const FieldT shift = FieldT::multiplicative_generator;
+
+    std::vector<FieldT> f(n);
+    for (auto& x : f) x = FieldT::random_element();
+
+    for (const size_t blowup : blowups) {
+        std::cout << "[i] Blowup : " << blowup << " (" << blowup * n << " evaluations)" << std::endl;
+
+        std::vector<FieldT> u;
+        std::vector<FieldT> v;
+
+        // Padded Timing Measure
+        {
+        std::cout << "[*] processing Padded Coset FFT";
+        std::cout.flush();
+        auto start_time = std::chrono::high_resolution_clock::now();
+        u = f;
+        u.resize(blowup * n, FieldT::zero());
+        _multiply_by_coset(u, shift);
+        if (multicore) _basic_parallel_radix2_FFT(u, libff::get_root_of_unity<FieldT>(blowup * n));
+        else _basic_serial_radix2_FFT(u, libff::get_root_of_unity<FieldT>(blowup * n));
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        auto minutes = duration.count() / 60000;
+        auto seconds = (duration.count() % 60000) / 1000;
+        auto milliseconds = duration.count() % 1000;
+
+        std::cout << std::dec;
+        std::cout << std::setw(_print_align) << std::left << "\r[+] Padded Coset FFT process complete"
+                  << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+        }
+
+        // LDE Timing Measure
+        {
+        std::cout << "[*] processing LDE";
+        std::cout.flush();
+        auto start_time = std::chrono::high_resolution_clock::now();
+        low_degree_extension(f, blowup, shift, v, engine, multicore);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        auto minutes = duration.count() / 60000;
+        auto seconds = (duration.count() % 60000) / 1000;
+        auto milliseconds = duration.count() % 1000;
+
+        std::cout << std::dec;
+        std::cout << std::setw(_print_align) << std::left << "\r[+] LDE process complete"
+                  << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+        }
+
+        if (u != v) std::cout << "Padded and LDE Results are different" << std::endl;
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int opt;
+    std::vector<int> sizes;
+    std::vector<size_t> blowups;
+    bool multicore = false;
+    ntt_engine engine = ntt_engine::libfqfft;
+
+    while ((opt = getopt(argc, argv, "n:k:me:")) != -1) {
+        switch (opt) {
+            case 'n':
+                sizes.push_back(std::stoi(optarg));
+                break;
+            case 'k':
+                blowups.push_back(std::stoul(optarg));
+                break;
+            case 'm':
+                multicore = true;
+                break;
+            case 'e':
+                if (parse_ntt_engine(optarg, engine)) break;
+                std::cerr << "[-] Unknown engine " << optarg << " (libfqfft|stockham|radix2)" << std::endl;
+                return 1;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-m] [-e libfqfft|stockham|radix2] [-k blowup]... [-n k]..." << std::endl;
+                return 1;
+        }
+    }
+
+    if (sizes.empty()) sizes = {16, 20};
+    if (blowups.empty()) blowups = {2, 4, 8};
+
+    bls12_381_pp::init_public_params();
+    std::cout << "[i] Mode : " << (multicore ? "Parallel" : "Serial") << std::endl;
+    std::cout << "\t- engine : " << ntt_engine_name(engine) << std::endl;
+
+    for (int i : sizes) {
+        std::cout << "# Test " << i << std::endl;
+        test(i, blowups, engine, multicore);
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,239 @@
+#ifndef MULTIPOINT_HPP
+#define MULTIPOINT_HPP
+
+#include "utils.hpp"
+#include "polynomial_multiplication.hpp"
+#include "polynomial_division.hpp"
+
+/* Products with an operand shorter than this are done schoolbook */
+const size_t subproduct_schoolbook_size = 1ul << 5;
+
+/* Remainders of at most this many coefficients are evaluated by Horner instead of split further */
+const size_t multipoint_leaf_size = 1ul << 6;
+
+/*
+ * Subproduct tree over the points x_0 .. x_{m-1}. Node i of level h is the monic
+ * product of (x - x_j) for j in [i 2^h, min((i + 1) 2^h, m)). Its leading 1 is
+ * implicit, so the remaining coefficients fit exactly in the node's point slots
+ * and each level is one flat vector of m elements.
+ */
+template <typename FieldT>
+struct subproduct_tree
+{
+    std::vector<FieldT> points;
+    std::vector<std::vector<FieldT> > levels;
+};
+
+/* c = a * b for the tree: schoolbook for short operands, the NTT linear product otherwise */
+template <typename FieldT>
+void tree_multiply(const std::vector<FieldT>& a, const std::vector<FieldT>& b, std::vector<FieldT>& c,
+                   const ntt_engine engine, const bool multicore)
+{
+    if (a.empty() || b.empty()) {
+        c.clear();
+        return;
+    }
+    const size_t size = a.size() + b.size() - 1;
+    if (std::min(a.size(), b.size()) < subproduct_schoolbook_size) {
+        c.assign(size, FieldT::zero());
+        for (size_t i = 0; i < a.size(); ++i)
+            for (size_t j = 0; j < b.size(); ++j) c[i + j] += a[i] * b[j];
+        return;
+    }
+    if (multicore) polynomial_multiplication_on_FFT_parallel(a, b, c, convolution_kind::linear, engine);
+    else polynomial_multiplication_on_FFT_serial(a, b, c, convolution_kind::linear, engine);
+    c.resize(size, FieldT::zero());
+}
+
+/* Nodes of one level run in parallel while there are enough of them; the few top nodes get parallel products instead */
+template <typename Function>
+void for_each_tree_node(const size_t count, const bool multicore, Function fn)
+{
+    if (multicore && count >= static_cast<size_t>(omp_get_max_threads())) {
+        #pragma omp parallel for schedule(dynamic)
+        for (size_t i = 0; i < count; ++i) fn(i, false);
+    } else {
+        for (size_t i = 0; i < count; ++i) fn(i, multicore);
+    }
+}
+
+/* Full coefficients of node i of level h, leading 1 included */
+template <typename FieldT>
+void subproduct_node(const subproduct_tree<FieldT>& tree, const size_t h, const size_t i, std::vector<FieldT>& node)
+{
+    const size_t m = tree.points.size();
+    const size_t begin = i << h;
+    const size_t count = std::min(1ul << h, m - begin);
+    node.assign(tree.levels[h].begin() + begin, tree.levels[h].begin() + begin + count);
+    node.push_back(FieldT::one());
+}
+
+template <typename FieldT>
+void build_subproduct_tree(const std::vector<FieldT>& points, subproduct_tree<FieldT>& tree,
+                           const ntt_engine engine, const bool multicore)
+{
+    const size_t m = points.size();
+    tree.points = points;
+    tree.levels.assign(1, std::vector<FieldT>(m));
+
+    #pragma omp parallel for if(multicore)
+    for (size_t i = 0; i < m; ++i) tree.levels[0][i] = -points[i];
+
+    for (size_t h = 0; (1ul << h) < m; ++h) {
+        tree.levels.emplace_back(m);
+        const std::vector<FieldT>& child = tree.levels[h];
+        std::vector<FieldT>& parent = tree.levels[h + 1];
+        const size_t half = 1ul << h;
+
+        /* (L' + x^l)(R' + x^r) = L'R' + x^l R' + x^r L' + x^(l + r), the last term staying implicit */
+        for_each_tree_node((m + 2 * half - 1) / (2 * half), multicore, [&](const size_t j, const bool inner) {
+            const size_t begin = 2 * half * j;
+            const size_t left = std::min(half, m - begin);
+            const size_t right = begin + half < m ? std::min(half, m - begin - half) : 0;
+            if (right == 0) {
+                std::copy(child.begin() + begin, child.begin() + begin + left, parent.begin() + begin);
+                return;
+            }
+
+            std::vector<FieldT> l(child.begin() + begin, child.begin() + begin + left);
+            std::vector<FieldT> r(child.begin() + begin + left, child.begin() + begin + left + right);
+            std::vector<FieldT> p;
+            tree_multiply(l, r, p, engine, inner);
+            p.resize(left + right, FieldT::zero());
+            for (size_t k = 0; k < right; ++k) p[left + k] += r[k];
+            for (size_t k = 0; k < left; ++k) p[right + k] += l[k];
+            std::copy(p.begin(), p.end(), parent.begin() + begin);
+        });
+    }
+}
+
+/*
+ * values[i] = f(x_i) through the remainder tree: f mod root, then each node's
+ * remainder mod its two children, with the levels ping-ponging between two
+ * flat buffers. Blocks of at most multipoint_leaf_size points finish by Horner.
+ */
+template <typename FieldT>
+void multipoint_evaluate(const std::vector<FieldT>& f, const subproduct_tree<FieldT>& tree, std::vector<FieldT>& values,
+                         const ntt_engine engine, const bool multicore)
+{
+    const size_t m = tree.points.size();
+    values.assign(m, FieldT::zero());
+    if (m == 0) return;
+
+    size_t h = tree.levels.size() - 1;
+    std::vector<FieldT> rem(m, FieldT::zero());
+    std::vector<FieldT> next(m, FieldT::zero());
+    {
+        std::vector<FieldT> root;
+        std::vector<FieldT> q;
+        std::vector<FieldT> r;
+        subproduct_node(tree, h, 0, root);
+        polynomial_division_on_FFT(q, r, f, root, engine, multicore);
+        std::copy(r.begin(), r.end(), rem.begin());
+    }
+
+    for (; h > 0 && (1ul << h) > multipoint_leaf_size; --h) {
+        const size_t half = 1ul << (h - 1);
+
+        for_each_tree_node((m + half - 1) / half, multicore, [&](const size_t i, const bool inner) {
+            const size_t begin = half * i;
+            const size_t count = std::min(half, m - begin);
+            const size_t parent_begin = 2 * half * (i / 2);
+            const size_t parent_count = std::min(2 * half, m - parent_begin);
+
+            std::fill(next.begin() + begin, next.begin() + begin + count, FieldT::zero());
+            if (parent_count == count) {
+                std::copy(rem.begin() + begin, rem.begin() + begin + count, next.begin() + begin);
+                return;
+            }
+
+            std::vector<FieldT> parent(rem.begin() + parent_begin, rem.begin() + parent_begin + parent_count);
+            std::vector<FieldT> node;
+            std::vector<FieldT> q;
+            std::vector<FieldT> r;
+            subproduct_node(tree, h - 1, i, node);
+            polynomial_division_on_FFT(q, r, parent, node, engine, inner);
+            std::copy(r.begin(), r.end(), next.begin() + begin);
+        });
+        std::swap(rem, next);
+    }
+
+    const size_t block = 1ul << h;
+    #pragma omp parallel for if(multicore)
+    for (size_t i = 0; i < m; ++i) {
+        const size_t begin = i - i % block;
+        const size_t count = std::min(block, m - begin);
+        FieldT acc = FieldT::zero();
+        for (size_t k = count; k-- > 0;) acc = acc * tree.points[i] + rem[begin + k];
+        values[i] = acc;
+    }
+}
+
+/*
+ * f with f(x_i) = values[i], deg f < m: Lagrange weights c_i = values[i] / M'(x_i)
+ * from one multipoint evaluation of the root's derivative, then the tree is
+ * walked bottom-up with P = P_L M_R + P_R M_L, again on two flat buffers.
+ */
+template <typename FieldT>
+void multipoint_interpolate(const subproduct_tree<FieldT>& tree, const std::vector<FieldT>& values, std::vector<FieldT>& f,
+                            const ntt_engine engine, const bool multicore)
+{
+    const size_t m = tree.points.size();
+    if (values.size() != m) throw DomainSizeException("expected values.size() == points.size()");
+    f.clear();
+    if (m == 0) return;
+
+    const std::vector<FieldT>& root = tree.levels.back();
+    std::vector<FieldT> derivative(m);
+    #pragma omp parallel for if(multicore)
+    for (size_t i = 0; i < m; ++i) derivative[i] = FieldT(i + 1) * (i + 1 < m ? root[i + 1] : FieldT::one());
+
+    std::vector<FieldT> weights;
+    multipoint_evaluate(derivative, tree, weights, engine, multicore);
+    for (const FieldT& w : weights)
+        if (w.is_zero()) throw InvalidSizeException("expected distinct points");
+
+    batch_inverse(weights, multicore);
+
+    std::vector<FieldT> cur(m);
+    std::vector<FieldT> next(m);
+    #pragma omp parallel for if(multicore)
+    for (size_t i = 0; i < m; ++i) cur[i] = values[i] * weights[i];
+
+    for (size_t h = 0; (1ul << h) < m; ++h) {
+        const std::vector<FieldT>& level = tree.levels[h];
+        const size_t half = 1ul << h;
+
+        /* P_L (M_R' + x^r) + P_R (M_L' + x^l) */
+        for_each_tree_node((m + 2 * half - 1) / (2 * half), multicore, [&](const size_t j, const bool inner) {
+            const size_t begin = 2 * half * j;
+            const size_t left = std::min(half, m - begin);
+            const size_t right = begin + half < m ? std::min(half, m - begin - half) : 0;
+            if (right == 0) {
+                std::copy(cur.begin() + begin, cur.begin() + begin + left, next.begin() + begin);
+                return;
+            }
+
+            std::vector<FieldT> pl(cur.begin() + begin, cur.begin() + begin + left);
+            std::vector<FieldT> pr(cur.begin() + begin + left, cur.begin() + begin + left + right);
+            std::vector<FieldT> ml(level.begin() + begin, level.begin() + begin + left);
+            std::vector<FieldT> mr(level.begin() + begin + left, level.begin() + begin + left + right);
+            std::vector<FieldT> a;
+            std::vector<FieldT> b;
+            tree_multiply(pl, mr, a, engine, inner);
+            tree_multiply(pr, ml, b, engine, inner);
+
+            a.resize(left + right, FieldT::zero());
+            for (size_t k = 0; k < b.size(); ++k) a[k] += b[k];
+            for (size_t k = 0; k < left; ++k) a[right + k] += pl[k];
+            for (size_t k = 0; k < right; ++k) a[left + k] += pr[k];
+            std::copy(a.begin(), a.end(), next.begin() + begin);
+        });
+        std::swap(cur, next);
+    }
+
+    f = cur;
+    _condense(f);
+}
+
+#endif // MULTIPOINT_HPP
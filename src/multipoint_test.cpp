@@ -0,0 +1,141 @@
+#include "utils.hpp"
+#include "multipoint.hpp"
+
+/* Evaluate a 2^k polynomial at 2^k random points, interpolate it back, and time each step */
+int test(int k, const bool naive, const ntt_engine engine, const bool multicore)
+{
+    const size_t m = 1ul << k;
+
+    std::vector<FieldT> f(m);
+    std::vector<FieldT> points(m);
+    for (auto& x : f) x = FieldT::random_element();
+    for (auto& x : points) x = FieldT::random_element();
+
+    subproduct_tree<FieldT> tree;
+    std::vector<FieldT> values;
+    std::vector<FieldT> naive_values;
+    std::vector<FieldT> g;
+
+    // Subproduct Tree Timing Measure
+    {
+    std::cout << "[*] processing Subproduct Tree";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    build_subproduct_tree(points, tree, engine, multicore);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Subproduct Tree process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    // Multipoint Evaluation Timing Measure
+    {
+    std::cout << "[*] processing Multipoint Evaluation";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    multipoint_evaluate(f, tree, values, engine, multicore);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Multipoint Evaluation process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    // Horner Timing Measure
+    if (naive) {
+    std::cout << "[*] processing Horner Evaluation";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    naive_values.resize(m);
+    #pragma omp parallel for if(multicore)
+    for (size_t i = 0; i < m; ++i) {
+        FieldT acc = FieldT::zero();
+        for (size_t j = m; j-- > 0;) acc = acc * points[i] + f[j];
+        naive_values[i] = acc;
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Horner Evaluation process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    // Interpolation Timing Measure
+    {
+    std::cout << "[*] processing Interpolation";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    multipoint_interpolate(tree, values, g, engine, multicore);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Interpolation process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    _condense(f);
+    if (naive && values != naive_values) std::cout << "Multipoint and Horner Results are different" << std::endl;
+    if (g != f) std::cout << "Interpolation does not recover the polynomial" << std::endl;
+
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int opt;
+    std::vector<int> sizes;
+    int naive_max = 14;
+    bool multicore = false;
+    ntt_engine engine = ntt_engine::libfqfft;
+
+    while ((opt = getopt(argc, argv, "n:s:me:")) != -1) {
+        switch (opt) {
+            case 'n':
+                sizes.push_back(std::stoi(optarg));
+                break;
+            case 's':
+                naive_max = std::stoi(optarg);
+                break;
+            case 'm':
+                multicore = true;
+                break;
+            case 'e':
+                if (parse_ntt_engine(optarg, engine)) break;
+                std::cerr << "[-] Unknown engine " << optarg << " (libfqfft|stockham|radix2)" << std::endl;
+                return 1;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-m] [-e libfqfft|stockham|radix2] [-s k] [-n k]..." << std::endl;
+                return 1;
+        }
+    }
+
+    if (sizes.empty()) sizes = {12, 14, 16, 18, 20};
+
+    bls12_381_pp::init_public_params();
+    std::cout << "[i] Mode : " << (multicore ? "Parallel" : "Serial") << std::endl;
+    std::cout << "\t- engine : " << ntt_engine_name(engine) << std::endl;
+
+    for (int i : sizes) {
+        std::cout << "# Test " << i << std::endl;
+        test(i, i <= naive_max, engine, multicore);
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,677 @@
+#ifndef NTT_HPP
+#define NTT_HPP
+
+#include "utils.hpp"
+#include "ntt_profile.hpp"
+#include "ntt_trace.hpp"
+#include "ntt_work_counts.hpp"
+
+// Code from libff
+template<typename FieldT>
+void baseline_serial_ntt(std::vector<FieldT> &a, const FieldT &omega)
+{
+    const size_t n = a.size(), logn = log2(n);
+    if (n != (1u << logn)) throw DomainSizeException("expected n == (1u << logn)");
+
+    /* swapping in place (from Storer's book) */
+    NTT_PROFILE_STAGE("serial bitreverse", -1);
+    for (size_t k = 0; k < n; ++k)
+    {
+        const size_t rk = libff::bitreverse(k, logn);
+        if (k < rk)
+            std::swap(a[k], a[rk]);
+    }
+
+    size_t m = 1; // invariant: m = 2^{s-1}
+    for (size_t s = 1; s <= logn; ++s)
+    {
+        // w_m is 2^s-th root of unity now
+        const FieldT w_m = omega^(n/(2*m));
+
+        NTT_PROFILE_STAGE("serial stage", s - 1);
+        asm volatile  ("/* pre-inner */");
+        for (size_t k = 0; k < n; k += 2*m)
+        {
+            FieldT w = FieldT::one();
+            for (size_t j = 0; j < m; ++j)
+            {
+                const FieldT t = w * a[k+j+m];
+                a[k+j+m] = a[k+j] - t;
+                a[k+j] += t;
+                w *= w_m;
+            }
+        }
+        asm volatile ("/* post-inner */");
+        m *= 2;
+    }
+    NTT_PROFILE_STOP();
+}
+
+template<typename FieldT>
+void baseline_parallel_ntt(std::vector<FieldT> &a, const FieldT &omega, const size_t log_cpus)
+{
+    const size_t num_cpus = 1ul<<log_cpus;
+
+    const size_t m = a.size();
+    const size_t log_m = log2(m);
+    if (m != 1ul<<log_m) throw DomainSizeException("expected m == 1ul<<log_m");
+
+    if (log_m < log_cpus)
+    {
+        _basic_serial_radix2_FFT(a, omega);
+        return;
+    }
+
+    ntt_trace_span region("baseline_parallel_ntt", ntt_trace_kind::region);
+    std::vector<std::vector<FieldT> > tmp(num_cpus);
+    for (size_t j = 0; j < num_cpus; ++j)
+    {
+        tmp[j].resize(1ul<<(log_m-log_cpus), FieldT::zero());
+    }
+
+    NTT_PROFILE_TEAM_STAGE("baseline_parallel gather", -1);
+    #pragma omp parallel for
+    for (size_t j = 0; j < num_cpus; ++j)
+    {
+        ntt_trace_span work("gather", ntt_trace_kind::work, j);
+        const FieldT omega_j = omega^j;
+        const FieldT omega_step = omega^(j<<(log_m - log_cpus));
+
+        FieldT elt = FieldT::one();
+        for (size_t i = 0; i < 1ul<<(log_m - log_cpus); ++i)
+        {
+            for (size_t s = 0; s < num_cpus; ++s)
+            {
+                // invariant: elt is omega^(j*idx)
+                const size_t idx = (i + (s<<(log_m - log_cpus))) % (1u << log_m);
+                tmp[j][i] += a[idx] * elt;
+                elt *= omega_step;
+            }
+            elt *= omega_j;
+        }
+    }
+
+    const FieldT omega_num_cpus = omega^num_cpus;
+
+    NTT_PROFILE_TEAM_STAGE("baseline_parallel sub-ffts", -1);
+    #pragma omp parallel for
+    for (size_t j = 0; j < num_cpus; ++j)
+    {
+        ntt_trace_span work("sub-fft", ntt_trace_kind::work, j);
+        _basic_serial_radix2_FFT(tmp[j], omega_num_cpus);
+    }
+
+    NTT_PROFILE_TEAM_STAGE("baseline_parallel scatter", -1);
+    #pragma omp parallel for
+    for (size_t i = 0; i < num_cpus; ++i)
+    {
+        ntt_trace_span work("scatter", ntt_trace_kind::work, i);
+        for (size_t j = 0; j < 1ul<<(log_m - log_cpus); ++j)
+        {
+            // now: i = idx >> (log_m - log_cpus) and j = idx % (1u << (log_m - log_cpus)), for idx = ((i<<(log_m-log_cpus))+j) % (1u << log_m)
+            a[(j<<log_cpus) + i] = tmp[i][j];
+        }
+    }
+    NTT_PROFILE_TEAM_STOP();
+}
+
+/* v[i] = scale * g^i for i < count */
+template<typename FieldT>
+void ntt_powers(std::vector<FieldT> &v, const size_t count, const FieldT &g, const FieldT &scale = FieldT::one())
+{
+    v.resize(count);
+    if (v.empty()) return;
+
+    v[0] = scale;
+    for (size_t i = 1; i < count; ++i)
+        v[i] = v[i-1] * g;
+}
+
+template<typename FieldT>
+void ntt_powers_parallel(std::vector<FieldT> &v, const size_t count, const FieldT &g, const FieldT &scale = FieldT::one())
+{
+    v.resize(count);
+
+    /* Built in chunks so the setup itself does not serialise */
+    #pragma omp parallel
+    {
+        const size_t nthreads = omp_get_num_threads();
+        const size_t tid = omp_get_thread_num();
+        const size_t chunk = (count + nthreads - 1) / nthreads;
+        const size_t begin = std::min(count, tid * chunk);
+        const size_t end = std::min(count, begin + chunk);
+        if (begin < end)
+        {
+            FieldT elt = scale * (g^begin);
+            for (size_t i = begin; i < end; ++i)
+            {
+                v[i] = elt;
+                elt *= g;
+            }
+        }
+    }
+}
+
+/*
+ * Invert every non-zero element in place (Montgomery's trick). Each thread takes
+ * one contiguous chunk, keeps its prefix products, inverts the chunk total once
+ * and walks back, so n inversions cost one inversion per thread plus about 3n
+ * multiplications. Zeros are skipped and stay zero.
+ */
+template<typename FieldT>
+void batch_inverse(std::vector<FieldT> &v, const bool multicore)
+{
+    const size_t count = v.size();
+
+    #pragma omp parallel if(multicore)
+    {
+        const size_t nthreads = omp_get_num_threads();
+        const size_t tid = omp_get_thread_num();
+        const size_t chunk = (count + nthreads - 1) / nthreads;
+        const size_t begin = std::min(count, tid * chunk);
+        const size_t end = std::min(count, begin + chunk);
+
+        // invariant: prefix[i - begin] is the product of the non-zero v[begin .. i)
+        std::vector<FieldT> prefix(end - begin);
+        FieldT acc = FieldT::one();
+        for (size_t i = begin; i < end; ++i)
+        {
+            prefix[i - begin] = acc;
+            if (!v[i].is_zero()) acc *= v[i];
+        }
+
+        FieldT inv = acc.inverse();
+        for (size_t i = end; i-- > begin;)
+        {
+            if (v[i].is_zero()) continue;
+            const FieldT x = v[i];
+            v[i] = inv * prefix[i - begin];
+            inv *= x;
+        }
+    }
+}
+
+/*
+ * Geometric scaling x[i] *= scale * step^i that a kernel folds into its
+ * first (pre) or last (post) pass instead of spending a separate pass on it.
+ * psi-twisting for negacyclic convolution and the 1/n of the inverse are both
+ * of this form.
+ */
+template<typename FieldT>
+struct ntt_twist
+{
+    FieldT scale;
+    FieldT step;
+
+    ntt_twist() : scale(FieldT::one()), step(FieldT::one()) {}
+    ntt_twist(const FieldT &scale, const FieldT &step) : scale(scale), step(step) {}
+
+    bool is_identity() const { return scale == FieldT::one() && step == FieldT::one(); }
+};
+
+/* dst = first n coefficients of src (zero padded), each scaled by the twist on the way. dst may be src. */
+template<typename FieldT>
+void twisted_copy_serial(std::vector<FieldT> &dst, const std::vector<FieldT> &src, const size_t n, const ntt_twist<FieldT> &twist)
+{
+    const size_t m = std::min(n, src.size());
+    if (&dst != &src) dst.assign(src.begin(), src.begin() + m);
+    dst.resize(n, FieldT::zero());
+    if (&dst != &src || !twist.is_identity()) ntt_count_pass();
+    if (twist.is_identity()) return;
+
+    FieldT elt = twist.scale;
+    for (size_t i = 0; i < m; ++i)
+    {
+        dst[i] *= elt;
+        elt *= twist.step;
+    }
+}
+
+template<typename FieldT>
+void twisted_copy_parallel(std::vector<FieldT> &dst, const std::vector<FieldT> &src, const size_t n, const ntt_twist<FieldT> &twist)
+{
+    const size_t m = std::min(n, src.size());
+    const bool identity = twist.is_identity();
+    if (&dst == &src && identity)
+    {
+        dst.resize(n, FieldT::zero());
+        return;
+    }
+    ntt_count_pass();
+    if (&dst == &src) dst.resize(n, FieldT::zero());
+    else dst.resize(n);
+
+    #pragma omp parallel
+    {
+        const size_t nthreads = omp_get_num_threads();
+        const size_t tid = omp_get_thread_num();
+        const size_t chunk = (n + nthreads - 1) / nthreads;
+        const size_t begin = std::min(n, tid * chunk);
+        const size_t end = std::min(n, begin + chunk);
+        if (begin < end)
+        {
+            FieldT elt = identity ? FieldT::one() : twist.scale * (twist.step^begin);
+            for (size_t i = begin; i < end; ++i)
+            {
+                if (i >= m) dst[i] = FieldT::zero();
+                else if (identity) dst[i] = src[i];
+                else
+                {
+                    dst[i] = src[i] * elt;
+                    elt *= twist.step;
+                }
+            }
+        }
+    }
+}
+
+/*
+ * Primitive n-th root of unity for any n dividing p - 1, e.g. 3 * 2^k.
+ * Powers of two keep libff's choice so results match get_root_of_unity.
+ */
+template<typename FieldT>
+FieldT get_smooth_root_of_unity(const size_t n)
+{
+    if (libff::is_power_of_2(n)) return libff::get_root_of_unity<FieldT>(n);
+
+    mpz_t e;
+    mpz_init(e);
+    FieldT::mod.to_mpz(e);
+    mpz_sub_ui(e, e, 1);
+    if (!mpz_divisible_ui_p(e, n))
+    {
+        mpz_clear(e);
+        throw DomainSizeException("expected n to divide p - 1");
+    }
+    mpz_divexact_ui(e, e, n);
+    const bigint<FieldT::num_limbs> exponent(e);
+    mpz_clear(e);
+
+    return FieldT::multiplicative_generator ^ exponent;
+}
+
+/* Smallest transform size of the form 2^k or 3 * 2^k covering len */
+inline size_t get_smooth_size(const size_t len)
+{
+    const size_t pow2 = libff::get_power_of_two(len);
+    const size_t mixed = 3 * libff::get_power_of_two((len + 2) / 3);
+    return std::min(pow2, mixed);
+}
+
+/*
+ * Radix-3 decimation-in-frequency pass of a size n = 3m NTT.
+ * Reads a (zero padded to n, scaled by `pre`) and writes the three length-m
+ * blocks y[r][j] = omega^(r*j) * sum_t zeta^(r*t) a[j + t*m], zeta = omega^m.
+ * A size-m NTT of y[r] with omega^3 then gives A(omega^(3k + r)) at y[r][k],
+ * so the transform ends in block order; radix3_merge undoes exactly that.
+ * Folding the copy-in into this pass means a mixed-radix transform reads its
+ * input only once.
+ */
+template<typename FieldT>
+void radix3_split(std::vector<FieldT> (&y)[3], const std::vector<FieldT> &a, const size_t n, const FieldT &omega,
+                  const ntt_twist<FieldT> &pre, const bool multicore)
+{
+    if (n % 3 != 0) throw DomainSizeException("expected n % 3 == 0");
+    const size_t m = n / 3;
+    const FieldT zeta = omega^m;
+    const FieldT pre_m = pre.step^m;
+    const bool twisted = !pre.is_identity();
+
+    for (size_t r = 0; r < 3; ++r) y[r].resize(m);
+    ntt_count_pass();
+
+    #pragma omp parallel if(multicore)
+    {
+        const size_t nthreads = omp_get_num_threads();
+        const size_t tid = omp_get_thread_num();
+        const size_t chunk = (m + nthreads - 1) / nthreads;
+        const size_t begin = std::min(m, tid * chunk);
+        const size_t end = std::min(m, begin + chunk);
+        if (begin < end)
+        {
+            FieldT w = omega^begin;
+            FieldT tw = twisted ? pre.scale * (pre.step^begin) : FieldT::one();
+            for (size_t j = begin; j < end; ++j)
+            {
+                FieldT a0 = (j < a.size()) ? a[j] : FieldT::zero();
+                FieldT a1 = (j + m < a.size()) ? a[j + m] : FieldT::zero();
+                FieldT a2 = (j + 2 * m < a.size()) ? a[j + 2 * m] : FieldT::zero();
+                if (twisted)
+                {
+                    const FieldT t1 = tw * pre_m;
+                    a0 *= tw;
+                    a1 *= t1;
+                    a2 *= t1 * pre_m;
+                    tw *= pre.step;
+                }
+
+                // zeta^2 = -1 - zeta, so each output needs one multiplication by zeta
+                const FieldT d = zeta * (a1 - a2);
+                y[0][j] = a0 + a1 + a2;
+                y[1][j] = (a0 - a2 + d) * w;
+                y[2][j] = (a0 - a1 - d) * w.squared();
+                w *= omega;
+            }
+        }
+    }
+}
+
+/*
+ * Inverse of radix3_split: given the three blocks after their inverse size-m
+ * NTTs (with omega^-3), recombine into a of size n with the radix-3
+ * decimation-in-time pass for omega_inv. `post` scales the output, so it also
+ * carries the 1/n of the inverse transform.
+ */
+template<typename FieldT>
+void radix3_merge(std::vector<FieldT> &a, const std::vector<FieldT> (&y)[3], const FieldT &omega_inv,
+                  const ntt_twist<FieldT> &post, const bool multicore)
+{
+    const size_t m = y[0].size();
+    const size_t n = 3 * m;
+    const FieldT zeta = omega_inv^m;
+    const FieldT post_m = post.step^m;
+
+    a.resize(n);
+    ntt_count_pass();
+
+    #pragma omp parallel if(multicore)
+    {
+        const size_t nthreads = omp_get_num_threads();
+        const size_t tid = omp_get_thread_num();
+        const size_t chunk = (m + nthreads - 1) / nthreads;
+        const size_t begin = std::min(m, tid * chunk);
+        const size_t end = std::min(m, begin + chunk);
+        if (begin < end)
+        {
+            FieldT w = omega_inv^begin;
+            FieldT tw = post.scale * (post.step^begin);
+            for (size_t j = begin; j < end; ++j)
+            {
+                const FieldT b0 = y[0][j];
+                const FieldT b1 = y[1][j] * w;
+                const FieldT b2 = y[2][j] * w.squared();
+
+                const FieldT d = zeta * (b1 - b2);
+                const FieldT t1 = tw * post_m;
+                a[j] = (b0 + b1 + b2) * tw;
+                a[j + m] = (b0 - b2 + d) * t1;
+                a[j + 2 * m] = (b0 - b1 - d) * (t1 * post_m);
+
+                tw *= post.step;
+                w *= omega_inv;
+            }
+        }
+    }
+}
+
+/*
+ * One Stockham butterfly. `pre` is only set in the first stage (stride == 1),
+ * where the inputs are x[p] and x[p+half]; `post` is only set in the last
+ * stage (half == 1), where the outputs are y[q] and y[q+stride].
+ */
+template<typename FieldT>
+inline void stockham_butterfly(const FieldT *x, FieldT *y, const FieldT &wp,
+                               const size_t half, const size_t stride, const size_t p, const size_t q,
+                               const FieldT *pre, const FieldT &pre_half,
+                               const FieldT *post, const FieldT &post_half)
+{
+    FieldT u = x[stride * p + q];
+    FieldT v = x[stride * (p + half) + q];
+    if (pre)
+    {
+        u *= pre[p];
+        v *= pre[p] * pre_half;
+    }
+
+    FieldT y0 = u + v;
+    FieldT y1 = (u - v) * wp;
+    if (post)
+    {
+        y0 *= post[q];
+        y1 *= post[q] * post_half;
+    }
+
+    y[stride * (2 * p) + q] = y0;
+    y[stride * (2 * p + 1) + q] = y1;
+}
+
+/*
+ * Stockham autosort NTT (radix-2, decimation in frequency).
+ * Each stage reads `a` and writes `work` with unit stride in the inner loop,
+ * then the two buffers swap roles. The output is in natural order, so no
+ * bit-reversal pass is needed. `work` is resized to a.size() and its contents
+ * are clobbered; the result always ends up in `a`.
+ * `pre` scales the input inside the first stage, `post` scales the output
+ * inside the last stage.
+ */
+template<typename FieldT>
+void stockham_serial_ntt(std::vector<FieldT> &a, std::vector<FieldT> &work, const FieldT &omega,
+                         const ntt_twist<FieldT> &pre = ntt_twist<FieldT>(),
+                         const ntt_twist<FieldT> &post = ntt_twist<FieldT>())
+{
+    const size_t n = a.size(), logn = log2(n);
+    if (n != (1u << logn)) throw DomainSizeException("expected n == (1u << logn)");
+
+    work.resize(n);
+    ntt_count_transforms(1, n);
+    if (n == 1)
+    {
+        a[0] *= pre.scale * post.scale;
+        return;
+    }
+
+    std::vector<FieldT> w, pre_tab, post_tab;
+    ntt_powers(w, n / 2, omega);
+    if (!pre.is_identity()) ntt_powers(pre_tab, n / 2, pre.step, pre.scale);
+    if (!post.is_identity()) ntt_powers(post_tab, n / 2, post.step, post.scale);
+    const FieldT pre_half = pre.step^(n / 2);
+    const FieldT post_half = post.step^(n / 2);
+
+    FieldT *x = a.data();
+    FieldT *y = work.data();
+
+    // invariant: half * 2 * stride == n, and the current twiddle is omega^(stride*p)
+    for (size_t half = n / 2, stride = 1; half >= 1; half /= 2, stride *= 2)
+    {
+        const FieldT *pre_p = (stride == 1 && !pre_tab.empty()) ? pre_tab.data() : nullptr;
+        const FieldT *post_p = (half == 1 && !post_tab.empty()) ? post_tab.data() : nullptr;
+        NTT_PROFILE_STAGE("stockham_serial stage", log2(stride));
+        for (size_t p = 0; p < half; ++p)
+        {
+            const FieldT &wp = w[stride * p];
+            for (size_t q = 0; q < stride; ++q)
+                stockham_butterfly(x, y, wp, half, stride, p, q, pre_p, pre_half, post_p, post_half);
+        }
+        std::swap(x, y);
+    }
+    NTT_PROFILE_STOP();
+
+    if (x != a.data()) a.swap(work);
+}
+
+template<typename FieldT>
+void stockham_parallel_ntt(std::vector<FieldT> &a, std::vector<FieldT> &work, const FieldT &omega,
+                           const ntt_twist<FieldT> &pre = ntt_twist<FieldT>(),
+                           const ntt_twist<FieldT> &post = ntt_twist<FieldT>())
+{
+    const size_t n = a.size(), logn = log2(n);
+    if (n != (1u << logn)) throw DomainSizeException("expected n == (1u << logn)");
+
+    work.resize(n);
+    ntt_count_transforms(1, n);
+    if (n == 1)
+    {
+        a[0] *= pre.scale * post.scale;
+        return;
+    }
+
+    ntt_trace_span region("stockham_parallel_ntt", ntt_trace_kind::opaque);
+    std::vector<FieldT> w, pre_tab, post_tab;
+    ntt_powers_parallel(w, n / 2, omega);
+    if (!pre.is_identity()) ntt_powers_parallel(pre_tab, n / 2, pre.step, pre.scale);
+    if (!post.is_identity()) ntt_powers_parallel(post_tab, n / 2, post.step, post.scale);
+    const FieldT pre_half = pre.step^(n / 2);
+    const FieldT post_half = post.step^(n / 2);
+
+    FieldT *x = a.data();
+    FieldT *y = work.data();
+
+    for (size_t half = n / 2, stride = 1; half >= 1; half /= 2, stride *= 2)
+    {
+        const FieldT *pre_p = (stride == 1 && !pre_tab.empty()) ? pre_tab.data() : nullptr;
+        const FieldT *post_p = (half == 1 && !post_tab.empty()) ? post_tab.data() : nullptr;
+
+        /* Early stages have many short rows, late stages few long ones; collapsing keeps both busy */
+        NTT_PROFILE_TEAM_STAGE("stockham_parallel stage", log2(stride));
+        #pragma omp parallel for collapse(2)
+        for (size_t p = 0; p < half; ++p)
+        {
+            for (size_t q = 0; q < stride; ++q)
+                stockham_butterfly(x, y, w[stride * p], half, stride, p, q, pre_p, pre_half, post_p, post_half);
+        }
+        std::swap(x, y);
+    }
+    NTT_PROFILE_TEAM_STOP();
+
+    if (x != a.data()) a.swap(work);
+}
+
+/*
+ * In-place radix-2 Cooley-Tukey NTT over `lanes` equally sized vectors at once
+ * (decimation in time, bit-reversal first). Twiddles come from one table of
+ * omega powers, so each butterfly loads its twiddle once for every lane, and
+ * each stage is a single worksharing loop: transforming two operands together
+ * costs one barrier per stage instead of two. The table w[j] = omega^j,
+ * j < n/2, belongs to the caller, so repeated transforms of one size keep it.
+ */
+template<typename FieldT>
+void radix2_ntt_lanes(FieldT *const *x, const size_t lanes, const size_t n, const std::vector<FieldT> &w, const bool multicore)
+{
+    const size_t logn = log2(n);
+    if (n != (1u << logn)) throw DomainSizeException("expected n == (1u << logn)");
+    if (n == 1) return;
+    if (w.size() < n / 2) throw DomainSizeException("expected w.size() >= n / 2");
+    ntt_count_transforms(lanes, n);
+
+    ntt_trace_span region(multicore ? "radix2_ntt_lanes" : nullptr, ntt_trace_kind::region);
+
+    #pragma omp parallel if(multicore)
+    {
+        NTT_PROFILE_STAGE("radix2 bitreverse", -1);
+        {
+            ntt_trace_span work(multicore ? "bitreverse" : nullptr, ntt_trace_kind::work);
+            #pragma omp for nowait
+            for (size_t k = 0; k < n; ++k)
+            {
+                const size_t rk = libff::bitreverse(k, logn);
+                if (k < rk)
+                    for (size_t l = 0; l < lanes; ++l) std::swap(x[l][k], x[l][rk]);
+            }
+        }
+        ntt_trace_barrier(multicore);
+
+        // invariant: m = 2^logm, and the twiddle of butterfly j is omega^(j * n/(2m))
+        for (size_t logm = 0, m = 1; m < n; ++logm, m *= 2)
+        {
+            const size_t step = n / (2 * m);
+
+            NTT_PROFILE_STAGE("radix2 stage", logm);
+            {
+                ntt_trace_span work(multicore ? "stage" : nullptr, ntt_trace_kind::work, logm);
+                #pragma omp for nowait
+                for (size_t i = 0; i < n / 2; ++i)
+                {
+                    const size_t j = i & (m - 1);
+                    const size_t k = ((i >> logm) << (logm + 1)) + j;
+                    const FieldT &wj = w[j * step];
+                    for (size_t l = 0; l < lanes; ++l)
+                    {
+                        const FieldT t = wj * x[l][k + m];
+                        x[l][k + m] = x[l][k] - t;
+                        x[l][k] += t;
+                    }
+                }
+            }
+            ntt_trace_barrier(multicore);
+        }
+        NTT_PROFILE_STOP();
+    }
+}
+
+/* Builds the twiddle table for one call */
+template<typename FieldT>
+void radix2_ntt_lanes(FieldT *const *x, const size_t lanes, const size_t n, const FieldT &omega, const bool multicore)
+{
+    const size_t logn = log2(n);
+    if (n != (1u << logn)) throw DomainSizeException("expected n == (1u << logn)");
+    if (n == 1) return;
+
+    std::vector<FieldT> w;
+    if (multicore) ntt_powers_parallel(w, n / 2, omega);
+    else ntt_powers(w, n / 2, omega);
+    radix2_ntt_lanes(x, lanes, n, w, multicore);
+}
+
+template<typename FieldT>
+void radix2_serial_ntt(std::vector<FieldT> &a, const FieldT &omega)
+{
+    FieldT *x[1] = { a.data() };
+    radix2_ntt_lanes(x, 1, a.size(), omega, false);
+}
+
+template<typename FieldT>
+void radix2_parallel_ntt(std::vector<FieldT> &a, const FieldT &omega)
+{
+    FieldT *x[1] = { a.data() };
+    radix2_ntt_lanes(x, 1, a.size(), omega, true);
+}
+
+/* Forward transforms of both multiplication operands as two interleaved lanes */
+template<typename FieldT>
+void radix2_ntt_pair(std::vector<FieldT> &u, std::vector<FieldT> &v, const FieldT &omega, const bool multicore)
+{
+    if (u.size() != v.size()) throw DomainSizeException("expected u.size() == v.size()");
+    FieldT *x[2] = { u.data(), v.data() };
+    radix2_ntt_lanes(x, 2, u.size(), omega, multicore);
+}
+
+/*
+ * Transform kernels a multiplication can run on.
+ *  - libfqfft : _basic_serial/parallel_radix2_FFT
+ *  - stockham : out-of-place autosort, twist fused into the first/last stage
+ *  - radix2   : in-place Cooley-Tukey with a twiddle table; both operands are
+ *               forward-transformed together as two lanes
+ */
+enum class ntt_engine { libfqfft, stockham, radix2 };
+
+inline const char* ntt_engine_name(const ntt_engine engine)
+{
+    switch (engine) {
+        case ntt_engine::libfqfft: return "libfqfft (Cooley-Tukey)";
+        case ntt_engine::stockham: return "Stockham";
+        case ntt_engine::radix2:   return "radix-2 (paired lanes)";
+    }
+    return "unknown";
+}
+
+/* The name parse_ntt_engine takes, e.g. for file formats that need one token */
+inline const char* ntt_engine_key(const ntt_engine engine)
+{
+    switch (engine) {
+        case ntt_engine::libfqfft: return "libfqfft";
+        case ntt_engine::stockham: return "stockham";
+        case ntt_engine::radix2:   return "radix2";
+    }
+    return "unknown";
+}
+
+inline bool parse_ntt_engine(const std::string& name, ntt_engine& engine)
+{
+    if (name == "libfqfft") engine = ntt_engine::libfqfft;
+    else if (name == "stockham") engine = ntt_engine::stockham;
+    else if (name == "radix2") engine = ntt_engine::radix2;
+    else return false;
+    return true;
+}
+
+#endif // NTT_HPP
@@ -0,0 +1,209 @@
+#ifndef NTT_ACCESS_HPP
+#define NTT_ACCESS_HPP
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <libff/common/utils.hpp>
+
+/*
+ * Memory access streams of the NTT engines in ntt.hpp, replayed from their
+ * index arithmetic without the field arithmetic, so even a 2^27 transform is
+ * enumerated in seconds. A stream goes to a sink:
+ *  - sink.stage(name)        : a new stage begins (bitreverse, stage 3, ...);
+ *                              false skips the stage's accesses
+ *  - sink.thread(t)          : the accesses that follow are made by thread t
+ *  - sink.access(addr, write): one element load or store at byte address addr
+ *  - sink.compute()          : one butterfly (or gather term) worth of arithmetic
+ *  - sink.done()             : true once the sink wants no more accesses
+ *
+ * Kernels
+ *  - serial    : baseline_serial_ntt / _basic_serial_radix2_FFT (twiddles by recurrence, no table)
+ *  - four_step : baseline_parallel_ntt / _basic_parallel_radix2_FFT: p strided gathers into
+ *                p rows, p row transforms, and the transposing scatter back
+ *  - stockham  : stockham_*_ntt, ping-pong between a and work, twiddle table w
+ *  - radix2    : radix2_ntt_lanes, in place on every lane, twiddle table w
+ * Worksharing loops are split into the same static chunks as `omp for`, and
+ * the threads' iterations are interleaved one at a time, so a parallel
+ * stream mixes the rows each thread walks.
+ */
+
+enum class ntt_access_kernel { serial, four_step, stockham, radix2 };
+
+inline const char* ntt_access_kernel_name(const ntt_access_kernel kernel)
+{
+    switch (kernel) {
+        case ntt_access_kernel::serial:    return "serial";
+        case ntt_access_kernel::four_step: return "four_step";
+        case ntt_access_kernel::stockham:  return "stockham";
+        case ntt_access_kernel::radix2:    return "radix2";
+    }
+    return "unknown";
+}
+
+inline bool parse_ntt_access_kernel(const std::string& name, ntt_access_kernel& kernel)
+{
+    if (name == "serial") kernel = ntt_access_kernel::serial;
+    else if (name == "four_step") kernel = ntt_access_kernel::four_step;
+    else if (name == "stockham") kernel = ntt_access_kernel::stockham;
+    else if (name == "radix2") kernel = ntt_access_kernel::radix2;
+    else return false;
+    return true;
+}
+
+struct ntt_access_params
+{
+    ntt_access_kernel kernel = ntt_access_kernel::radix2;
+    size_t log_n = 20;
+    size_t threads = 1;         // four_step uses the largest power of two below as p
+    size_t lanes = 1;           // radix2 only: 2 is the forward pair of a multiplication
+    size_t element = 32;        // bytes per field element
+    uint64_t base = 0x10000000; // address of a[0]; further buffers follow, 4 KiB aligned
+};
+
+/* Static `omp for` schedule of `count` iterations over `threads`, one iteration per thread in turn */
+template<typename Sink, typename Body>
+void ntt_access_loop(Sink& sink, const size_t count, const size_t threads, Body body)
+{
+    const size_t chunk = (count + threads - 1) / threads;
+    for (size_t step = 0; step < chunk; ++step) {
+        if (sink.done()) return;
+        for (size_t t = 0; t < threads; ++t) {
+            const size_t i = t * chunk + step;
+            if (i >= count) continue;
+            sink.thread(t);
+            body(i);
+        }
+    }
+}
+
+inline uint64_t ntt_access_align(const uint64_t addr)
+{
+    return (addr + 4095) & ~uint64_t(4095);
+}
+
+/*
+ * Bit-reversal and butterflies of in-place radix-2 transforms of size n:
+ * x holds rows of `lanes` vectors each; the lanes of a row are transformed
+ * together and share one twiddle load from `table` (0: no table, twiddles
+ * by recurrence), while separate rows are separate transforms.
+ */
+template<typename Sink>
+void ntt_access_radix2(Sink& sink, const std::string& prefix, const std::vector<uint64_t>& x, const size_t lanes,
+                       const size_t n, const size_t threads, const size_t element, const uint64_t table)
+{
+    const size_t logn = libff::log2(n);
+    const size_t rows = x.size() / lanes;
+
+    if (sink.stage(prefix + "bitreverse")) ntt_access_loop(sink, rows * n, threads, [&](const size_t i) {
+        const size_t k = i % n;
+        const size_t rk = libff::bitreverse(k, logn);
+        if (k >= rk) return;
+        for (size_t l = 0; l < lanes; ++l) {
+            const uint64_t v = x[(i / n) * lanes + l];
+            sink.access(v + k * element, false);
+            sink.access(v + rk * element, false);
+            sink.access(v + k * element, true);
+            sink.access(v + rk * element, true);
+        }
+    });
+
+    for (size_t logm = 0, m = 1; m < n; ++logm, m *= 2) {
+        if (!sink.stage(prefix + "stage " + std::to_string(logm))) continue;
+        ntt_access_loop(sink, rows * (n / 2), threads, [&](const size_t i) {
+            const size_t b = i % (n / 2);
+            const size_t j = b & (m - 1);
+            const size_t k = ((b >> logm) << (logm + 1)) + j;
+            if (table) sink.access(table + j * (n / (2 * m)) * element, false);
+            for (size_t l = 0; l < lanes; ++l) {
+                const uint64_t v = x[(i / (n / 2)) * lanes + l];
+                sink.access(v + (k + m) * element, false);
+                sink.access(v + k * element, false);
+                sink.access(v + (k + m) * element, true);
+                sink.access(v + k * element, true);
+                sink.compute();
+            }
+        });
+    }
+}
+
+template<typename Sink>
+void ntt_access_stream(const ntt_access_params& params, Sink& sink)
+{
+    const size_t n = 1ul << params.log_n;
+    const size_t e = params.element;
+    const uint64_t a = params.base;
+    const uint64_t span = ntt_access_align(n * e);
+
+    switch (params.kernel) {
+        case ntt_access_kernel::serial: {
+            ntt_access_radix2(sink, "", std::vector<uint64_t>(1, a), 1, n, 1, e, 0);
+            break;
+        }
+        case ntt_access_kernel::radix2: {
+            /* Lanes are separate vectors; the twiddle table follows the last one */
+            std::vector<uint64_t> lane(params.lanes);
+            for (size_t l = 0; l < params.lanes; ++l) lane[l] = a + l * span;
+            ntt_access_radix2(sink, "", lane, params.lanes, n, params.threads, e, a + params.lanes * span);
+            break;
+        }
+        case ntt_access_kernel::stockham: {
+            uint64_t x = a;
+            uint64_t y = a + span;
+            const uint64_t w = a + 2 * span;
+            for (size_t half = n / 2, stride = 1; half >= 1; half /= 2, stride *= 2) {
+                if (sink.stage("stage " + std::to_string(libff::log2(stride)))) ntt_access_loop(sink, n / 2, params.threads, [&](const size_t i) {
+                    const size_t p = i / stride;
+                    const size_t q = i % stride;
+                    /* The serial kernel loads w[stride * p] once per row, the collapsed parallel loop per butterfly */
+                    if (q == 0 || params.threads > 1) sink.access(w + stride * p * e, false);
+                    sink.access(x + (stride * p + q) * e, false);
+                    sink.access(x + (stride * (p + half) + q) * e, false);
+                    sink.access(y + (stride * (2 * p) + q) * e, true);
+                    sink.access(y + (stride * (2 * p + 1) + q) * e, true);
+                    sink.compute();
+                });
+                std::swap(x, y);
+            }
+            break;
+        }
+        case ntt_access_kernel::four_step: {
+            const size_t t = params.threads;
+            const size_t log_p = (t & (t - 1)) == 0 ? libff::log2(t) : libff::log2(t) - 1;
+            if (t <= 1 || params.log_n < log_p) {
+                ntt_access_radix2(sink, "", std::vector<uint64_t>(1, a), 1, n, 1, e, 0);
+                break;
+            }
+            const size_t p = 1ul << log_p;
+            const size_t rows = n / p;
+            std::vector<uint64_t> tmp(p);
+            for (size_t j = 0; j < p; ++j) tmp[j] = a + span + j * ntt_access_align(rows * e);
+
+            /* Row j gathers sum_s a[i + s * rows] omega^(j * (i + s * rows)): p strided reads per element */
+            if (sink.stage("gather")) ntt_access_loop(sink, n, p, [&](const size_t i) {
+                const size_t j = i / rows;
+                const size_t r = i % rows;
+                for (size_t s = 0; s < p; ++s) {
+                    sink.access(a + ((r + s * rows) % n) * e, false);
+                    sink.compute();
+                }
+                sink.access(tmp[j] + r * e, true);
+            });
+
+            ntt_access_radix2(sink, "row ", tmp, 1, rows, p, e, 0);
+
+            /* a[(r << log_p) + j] = tmp[j][r]: row j lands on a stride-p column */
+            if (sink.stage("scatter")) ntt_access_loop(sink, n, p, [&](const size_t i) {
+                const size_t j = i / rows;
+                const size_t r = i % rows;
+                sink.access(tmp[j] + r * e, false);
+                sink.access(a + ((r << log_p) + j) * e, true);
+            });
+            break;
+        }
+    }
+}
+
+#endif // NTT_ACCESS_HPP
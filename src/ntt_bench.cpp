@@ -0,0 +1,443 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <map>
+#include <memory>
+
+#include "utils.hpp"
+#include "ntt.hpp"
+#include "ntt_op_counts.hpp"
+
+/*
+ * NTT benchmark sweep: kernel x log n x threads x direction, each point timed
+ * over repeated runs after warm-up, written as CSV or JSON for charting.
+ * Progress goes to stderr so stdout stays machine-readable. An op-count build
+ * (cmake -DNTT_OP_COUNTS=ON) adds the Fr operations of one more, untimed run;
+ * its timings include the counting overhead.
+ *
+ * With -R every row is also placed on a roofline: two micro-kernels measure
+ * the sustainable memory bandwidth (STREAM triad) and the peak Fr multiply
+ * rate per thread count, and each run reports its bytes moved, multiplies,
+ * achieved GB/s and Gmul/s, and the roof it is closest to.
+ */
+
+typedef std::function<void(std::vector<FieldT>&, const FieldT&, const FieldT&, std::vector<FieldT>&)> bench_kernel_fn;
+
+struct bench_kernel
+{
+    std::string name;
+    bool parallel;
+    bench_kernel_fn run;    // (a, omega, 1/n or one, work)
+};
+
+struct bench_result
+{
+    std::string kernel;
+    std::string direction;
+    size_t log_n;
+    size_t threads;
+    size_t reps;
+    long long min_ns;
+    long long median_ns;
+    long long p95_ns;
+    double elements_per_s;
+    double butterflies_per_s;
+    bool verified;
+    ntt_op_counts ops;
+    double bytes;
+    double muls;
+    double peak_bytes_per_s;
+    double peak_muls_per_s;
+};
+
+/* The two roofs at one thread count */
+struct bench_machine
+{
+    double bytes_per_s;
+    double muls_per_s;
+};
+
+/* x[i] *= scale, the 1/n of an inverse for kernels that cannot fold it */
+void bench_scale(std::vector<FieldT>& a, const FieldT& scale, const bool multicore)
+{
+    if (scale == FieldT::one()) return;
+    if (multicore) twisted_copy_parallel(a, a, a.size(), ntt_twist<FieldT>(scale, FieldT::one()));
+    else twisted_copy_serial(a, a, a.size(), ntt_twist<FieldT>(scale, FieldT::one()));
+}
+
+std::vector<bench_kernel> bench_kernels()
+{
+    std::vector<bench_kernel> kernels;
+    kernels.push_back({"serial", false, [](std::vector<FieldT>& a, const FieldT& omega, const FieldT& scale, std::vector<FieldT>&) {
+        baseline_serial_ntt(a, omega);
+        bench_scale(a, scale, false);
+    }});
+    kernels.push_back({"baseline_parallel", true, [](std::vector<FieldT>& a, const FieldT& omega, const FieldT& scale, std::vector<FieldT>&) {
+        const size_t num_cpus = omp_get_max_threads();
+        const size_t log_cpus = ((num_cpus & (num_cpus - 1)) == 0 ? log2(num_cpus) : log2(num_cpus) - 1);
+        baseline_parallel_ntt(a, omega, log_cpus);
+        bench_scale(a, scale, true);
+    }});
+    kernels.push_back({"libfqfft_serial", false, [](std::vector<FieldT>& a, const FieldT& omega, const FieldT& scale, std::vector<FieldT>&) {
+        _basic_serial_radix2_FFT(a, omega);
+        bench_scale(a, scale, false);
+    }});
+    kernels.push_back({"libfqfft_parallel", true, [](std::vector<FieldT>& a, const FieldT& omega, const FieldT& scale, std::vector<FieldT>&) {
+        _basic_parallel_radix2_FFT(a, omega);
+        bench_scale(a, scale, true);
+    }});
+    kernels.push_back({"stockham_serial", false, [](std::vector<FieldT>& a, const FieldT& omega, const FieldT& scale, std::vector<FieldT>& work) {
+        stockham_serial_ntt(a, work, omega, ntt_twist<FieldT>(), ntt_twist<FieldT>(scale, FieldT::one()));
+    }});
+    kernels.push_back({"stockham_parallel", true, [](std::vector<FieldT>& a, const FieldT& omega, const FieldT& scale, std::vector<FieldT>& work) {
+        stockham_parallel_ntt(a, work, omega, ntt_twist<FieldT>(), ntt_twist<FieldT>(scale, FieldT::one()));
+    }});
+    kernels.push_back({"radix2_serial", false, [](std::vector<FieldT>& a, const FieldT& omega, const FieldT& scale, std::vector<FieldT>&) {
+        radix2_serial_ntt(a, omega);
+        bench_scale(a, scale, false);
+    }});
+    kernels.push_back({"radix2_parallel", true, [](std::vector<FieldT>& a, const FieldT& omega, const FieldT& scale, std::vector<FieldT>&) {
+        radix2_parallel_ntt(a, omega);
+        bench_scale(a, scale, true);
+    }});
+    return kernels;
+}
+
+/*
+ * Streaming model of one run: every pass reads and writes the whole array (or
+ * reads its twiddle table) from memory, so the bytes are the traffic without
+ * cache reuse. Multiplies count the butterflies and the twiddle recurrences;
+ * an op-count build replaces them with the counted ones.
+ */
+void bench_model(const std::string& kernel, const bool inverse, const size_t n, const size_t threads, double& bytes, double& muls)
+{
+    const double e = sizeof(FieldT);
+    const double logn = log2(n);
+    const double pass = 2 * e * n;
+
+    if (kernel == "baseline_parallel" && threads > 1) {
+        const size_t p = 1ul << ((threads & (threads - 1)) == 0 ? log2(threads) : log2(threads) - 1);
+        /* Each of the p gathers reads all of a; p serial sub-transforms of n / p; one scatter */
+        bytes = p * e * n + e * n + (log2(n / p) + 1) * pass + pass;
+        muls = 2.0 * n * p + n * log2(n / p);
+    } else if (kernel.compare(0, 8, "stockham") == 0) {
+        bytes = logn * (pass + e * n / 2);
+        muls = n / 2 * logn + n / 2;
+    } else if (kernel.compare(0, 6, "radix2") == 0) {
+        bytes = pass + logn * (pass + e * n / 2);
+        muls = n / 2 * logn + n / 2;
+    } else {
+        /* serial, libfqfft: bit-reversal, then w *= w_m next to every butterfly */
+        bytes = pass + logn * pass;
+        muls = n * logn;
+    }
+
+    /* The 1/n of an inverse: a separate pass, except on the last Stockham stage */
+    if (inverse) {
+        muls += n;
+        if (kernel.compare(0, 8, "stockham") != 0) bytes += pass;
+    }
+}
+
+/* STREAM triad a = b + 3 c over three arrays of `bytes` each, best of 5, in bytes/s */
+double bench_bandwidth(const size_t threads, const size_t bytes)
+{
+    const size_t count = bytes / sizeof(uint64_t);
+    std::unique_ptr<uint64_t[]> a(new uint64_t[count]);
+    std::unique_ptr<uint64_t[]> b(new uint64_t[count]);
+    std::unique_ptr<uint64_t[]> c(new uint64_t[count]);
+
+    /* First touch by the thread that will stream each part */
+    #pragma omp parallel for schedule(static) num_threads(threads)
+    for (size_t i = 0; i < count; ++i) {
+        a[i] = 0;
+        b[i] = i;
+        c[i] = 2 * i;
+    }
+
+    double best = 0;
+    for (size_t rep = 0; rep < 5; ++rep) {
+        auto start_time = std::chrono::steady_clock::now();
+        #pragma omp parallel for schedule(static) num_threads(threads)
+        for (size_t i = 0; i < count; ++i) a[i] = b[i] + 3 * c[i];
+        auto end_time = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+        best = std::max(best, 3.0 * count * sizeof(uint64_t) / seconds);
+    }
+    if (a[count - 1] != 7 * (count - 1)) std::cerr << "[-] Bandwidth kernel result is wrong" << std::endl;
+    return best;
+}
+
+/* Fr multiplies/s with every thread running 4 independent chains, best of 3 */
+double bench_mul_rate(const size_t threads)
+{
+    const size_t iterations = 1ul << 18;
+    const size_t chains = 4;
+
+    double best = 0;
+    for (size_t rep = 0; rep < 3; ++rep) {
+        std::vector<FieldT> sink(threads);
+        auto start_time = std::chrono::steady_clock::now();
+        #pragma omp parallel num_threads(threads)
+        {
+            const FieldT y = FieldT::multiplicative_generator;
+            FieldT x[chains];
+            for (size_t c = 0; c < chains; ++c) x[c] = FieldT(c + 2);
+            for (size_t i = 0; i < iterations; ++i)
+                for (size_t c = 0; c < chains; ++c) x[c] *= y;
+            for (size_t c = 1; c < chains; ++c) x[0] += x[c];
+            sink[omp_get_thread_num()] = x[0];
+        }
+        auto end_time = std::chrono::steady_clock::now();
+        const double seconds = std::chrono::duration<double>(end_time - start_time).count();
+        best = std::max(best, static_cast<double>(threads * iterations * chains) / seconds);
+    }
+    return best;
+}
+
+/* Sorted sample at quantile q (nearest rank) */
+long long bench_quantile(const std::vector<long long>& sorted, const double q)
+{
+    const size_t rank = static_cast<size_t>(std::ceil(q * sorted.size()));
+    return sorted[std::min(sorted.size(), std::max<size_t>(rank, 1)) - 1];
+}
+
+bench_result bench_point(const bench_kernel& kernel, const std::string& direction, const size_t log_n, const size_t threads,
+                         const std::vector<FieldT>& input, const std::vector<FieldT>& reference, const size_t warmup, const size_t reps,
+                         const bench_machine& machine)
+{
+    const size_t n = input.size();
+    const bool inverse = (direction == "inverse");
+    const FieldT omega = libff::get_root_of_unity<FieldT>(n);
+    const FieldT root = inverse ? omega.inverse() : omega;
+    const FieldT scale = inverse ? FieldT(n).inverse() : FieldT::one();
+
+    std::vector<FieldT> a;
+    std::vector<FieldT> work;
+    std::vector<long long> samples;
+    for (size_t i = 0; i < warmup + reps; ++i) {
+        a = input;
+        auto start_time = std::chrono::steady_clock::now();
+        kernel.run(a, root, scale, work);
+        auto end_time = std::chrono::steady_clock::now();
+        if (i >= warmup) samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+    }
+    std::sort(samples.begin(), samples.end());
+
+    bench_result r;
+    r.kernel = kernel.name;
+    r.direction = direction;
+    r.log_n = log_n;
+    r.threads = threads;
+    r.reps = reps;
+    r.min_ns = samples.front();
+    r.median_ns = bench_quantile(samples, 0.5);
+    r.p95_ns = bench_quantile(samples, 0.95);
+    const double seconds = std::max<long long>(r.median_ns, 1) * 1e-9;
+    r.elements_per_s = n / seconds;
+    r.butterflies_per_s = (n / 2) * static_cast<double>(log_n) / seconds;
+    r.verified = (a == reference);
+
+    if (ntt_op_counting) {
+        a = input;
+        r.ops = ntt_count_ops(threads, [&] { kernel.run(a, root, scale, work); });
+    }
+
+    bench_model(kernel.name, inverse, n, threads, r.bytes, r.muls);
+    if (ntt_op_counting) r.muls = r.ops.mul + r.ops.sqr;
+    r.peak_bytes_per_s = machine.bytes_per_s;
+    r.peak_muls_per_s = machine.muls_per_s;
+    return r;
+}
+
+/* The roof the run is closest to: the larger share of the measured bandwidth or multiply rate */
+const char* bench_bound(const bench_result& r)
+{
+    const double seconds = std::max<long long>(r.median_ns, 1) * 1e-9;
+    return r.bytes / seconds / r.peak_bytes_per_s >= r.muls / seconds / r.peak_muls_per_s ? "memory" : "compute";
+}
+
+void write_csv(std::ostream& out, const std::vector<bench_result>& results, const bool roofline)
+{
+    out << "kernel,direction,log_n,threads,reps,min_ns,median_ns,p95_ns,elements_per_s,butterflies_per_s,verified";
+    if (ntt_op_counting) out << ",add,sub,mul,sqr,inv";
+    if (roofline) out << ",bytes,muls,gb_per_s,gmul_per_s,peak_gb_per_s,peak_gmul_per_s,bound";
+    out << std::endl;
+    for (const auto& r : results) {
+        out << r.kernel << "," << r.direction << "," << r.log_n << "," << r.threads << "," << r.reps << ","
+            << r.min_ns << "," << r.median_ns << "," << r.p95_ns << ","
+            << std::setprecision(6) << r.elements_per_s << "," << r.butterflies_per_s << ","
+            << (r.verified ? "true" : "false");
+        if (ntt_op_counting)
+            out << "," << r.ops.add << "," << r.ops.sub << "," << r.ops.mul << "," << r.ops.sqr << "," << r.ops.inv;
+        if (roofline) {
+            const double seconds = std::max<long long>(r.median_ns, 1) * 1e-9;
+            out << "," << r.bytes << "," << r.muls << "," << r.bytes / seconds * 1e-9 << "," << r.muls / seconds * 1e-9
+                << "," << r.peak_bytes_per_s * 1e-9 << "," << r.peak_muls_per_s * 1e-9 << "," << bench_bound(r);
+        }
+        out << std::endl;
+    }
+}
+
+void write_json(std::ostream& out, const std::vector<bench_result>& results, const bool roofline)
+{
+    out << "[" << std::endl;
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& r = results[i];
+        out << "  {\"kernel\": \"" << r.kernel << "\", \"direction\": \"" << r.direction << "\", \"log_n\": " << r.log_n
+            << ", \"threads\": " << r.threads << ", \"reps\": " << r.reps
+            << ", \"min_ns\": " << r.min_ns << ", \"median_ns\": " << r.median_ns << ", \"p95_ns\": " << r.p95_ns
+            << ", \"elements_per_s\": " << std::setprecision(6) << r.elements_per_s
+            << ", \"butterflies_per_s\": " << r.butterflies_per_s
+            << ", \"verified\": " << (r.verified ? "true" : "false");
+        if (ntt_op_counting)
+            out << ", \"add\": " << r.ops.add << ", \"sub\": " << r.ops.sub << ", \"mul\": " << r.ops.mul
+                << ", \"sqr\": " << r.ops.sqr << ", \"inv\": " << r.ops.inv;
+        if (roofline) {
+            const double seconds = std::max<long long>(r.median_ns, 1) * 1e-9;
+            out << ", \"bytes\": " << r.bytes << ", \"muls\": " << r.muls
+                << ", \"gb_per_s\": " << r.bytes / seconds * 1e-9 << ", \"gmul_per_s\": " << r.muls / seconds * 1e-9
+                << ", \"peak_gb_per_s\": " << r.peak_bytes_per_s * 1e-9 << ", \"peak_gmul_per_s\": " << r.peak_muls_per_s * 1e-9
+                << ", \"bound\": \"" << bench_bound(r) << "\"";
+        }
+        out << "}" << (i + 1 < results.size() ? "," : "") << std::endl;
+    }
+    out << "]" << std::endl;
+}
+
+int main(int argc, char* argv[]) {
+    int opt;
+    std::vector<int> sizes;
+    std::vector<int> thread_counts;
+    std::vector<std::string> kernel_names;
+    std::vector<std::string> directions = {"forward", "inverse"};
+    size_t warmup = 1;
+    size_t reps = 5;
+    std::string format = "csv";
+    std::string output;
+    bool roofline = false;
+    size_t stream_mb = 64;
+
+    while ((opt = getopt(argc, argv, "n:t:k:d:w:r:f:o:RB:")) != -1) {
+        switch (opt) {
+            case 'n':
+                sizes.push_back(std::stoi(optarg));
+                break;
+            case 't':
+                thread_counts.push_back(std::stoi(optarg));
+                break;
+            case 'k':
+                kernel_names.push_back(optarg);
+                break;
+            case 'd':
+                if (std::string(optarg) == "both") directions = {"forward", "inverse"};
+                else if (std::string(optarg) == "forward" || std::string(optarg) == "inverse") directions = {optarg};
+                else {
+                    std::cerr << "[-] Unknown direction " << optarg << " (forward|inverse|both)" << std::endl;
+                    return 1;
+                }
+                break;
+            case 'w':
+                warmup = std::stoul(optarg);
+                break;
+            case 'r':
+                reps = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'f':
+                format = optarg;
+                if (format == "csv" || format == "json") break;
+                std::cerr << "[-] Unknown format " << optarg << " (csv|json)" << std::endl;
+                return 1;
+            case 'o':
+                output = optarg;
+                break;
+            case 'R':
+                roofline = true;
+                break;
+            case 'B':
+                stream_mb = std::max(1ul, std::stoul(optarg));
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-n k]... [-t threads]... [-k kernel]... [-d forward|inverse|both]"
+                          << " [-w warmup] [-r reps] [-f csv|json] [-o file] [-R] [-B MB]" << std::endl;
+                return 1;
+        }
+    }
+
+    const int max_threads = omp_get_max_threads();
+    if (sizes.empty()) sizes = {10, 14, 18, 20};
+    if (thread_counts.empty()) thread_counts = {1, max_threads};
+    std::sort(thread_counts.begin(), thread_counts.end());
+    thread_counts.erase(std::unique(thread_counts.begin(), thread_counts.end()), thread_counts.end());
+
+    std::vector<bench_kernel> kernels;
+    for (const auto& k : bench_kernels())
+        if (kernel_names.empty() || std::find(kernel_names.begin(), kernel_names.end(), k.name) != kernel_names.end())
+            kernels.push_back(k);
+    if (kernels.empty()) {
+        std::cerr << "[-] No kernel selected (serial|baseline_parallel|libfqfft_serial|libfqfft_parallel|"
+                  << "stockham_serial|stockham_parallel|radix2_serial|radix2_parallel)" << std::endl;
+        return 1;
+    }
+
+    bls12_381_pp::init_public_params();
+
+    /* Roofs for every thread count a row can have (serial kernels run on one) */
+    std::map<size_t, bench_machine> machines;
+    if (roofline) {
+        std::vector<int> counts(thread_counts);
+        if (counts.front() != 1) counts.insert(counts.begin(), 1);
+        for (int threads : counts) {
+            std::cerr << "[*] roofline x" << threads << std::endl;
+            bench_machine& m = machines[threads];
+            m.bytes_per_s = bench_bandwidth(threads, stream_mb << 20);
+            m.muls_per_s = bench_mul_rate(threads);
+            std::cerr << "[i] Roofline x" << threads << " : " << std::setprecision(4) << m.bytes_per_s * 1e-9 << " GB/s, "
+                      << m.muls_per_s * 1e-9 << " Gmul/s, balance " << m.muls_per_s / m.bytes_per_s << " mul/B" << std::endl;
+        }
+    }
+
+    std::vector<bench_result> results;
+    for (int log_n : sizes) {
+        const size_t n = 1ul << log_n;
+        std::vector<FieldT> input(n);
+        for (auto& x : input) x = FieldT::random_element();
+
+        for (const auto& direction : directions) {
+            /* Reference from the serial libfqfft kernel, so every row also says whether its output was right */
+            std::vector<FieldT> reference(input);
+            const FieldT omega = libff::get_root_of_unity<FieldT>(n);
+            _basic_serial_radix2_FFT(reference, direction == "inverse" ? omega.inverse() : omega);
+            if (direction == "inverse") bench_scale(reference, FieldT(n).inverse(), false);
+
+            for (int threads : thread_counts) {
+                omp_set_num_threads(threads);
+                for (const auto& kernel : kernels) {
+                    /* Serial kernels ignore the thread count; one row for them is enough */
+                    if (!kernel.parallel && threads != thread_counts.front()) continue;
+                    std::cerr << "[*] " << kernel.name << " " << direction << " 2^" << log_n << " x" << threads << std::endl;
+                    const size_t run_threads = kernel.parallel ? threads : 1;
+                    results.push_back(bench_point(kernel, direction, log_n, run_threads, input, reference, warmup, reps, machines[run_threads]));
+                }
+            }
+        }
+    }
+    omp_set_num_threads(max_threads);
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file.is_open()) {
+            std::cerr << "[-] Unable to open file " << output << std::endl;
+            return 1;
+        }
+    }
+    std::ostream& out = output.empty() ? std::cout : file;
+    if (format == "json") write_json(out, results, roofline);
+    else write_csv(out, results, roofline);
+
+    for (const auto& r : results)
+        if (!r.verified) std::cerr << "[-] " << r.kernel << " " << r.direction << " 2^" << r.log_n << " result is wrong" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,184 @@
+#include "utils.hpp"
+#include "ntt_access.hpp"
+#include "cache_sim.hpp"
+#include "dramsim_trace.hpp"
+
+/*
+ * Cache-hierarchy filter for the NTT address streams of ntt_access.hpp.
+ *
+ * Every element access is split into the lines it touches and looked up in a
+ * set-associative hierarchy (private upper levels per thread, shared last
+ * level, LRU, write-back). Only the last level's misses and writebacks leave
+ * it, and with -o those are written as a DRAMSim3 trace, so the DRAM model
+ * sees the traffic a real LLC would let through instead of every load and
+ * store. The report gives the hit rate of each level for each kernel.
+ */
+
+struct cachesim_memory
+{
+    dramsim_trace_writer* writer = nullptr;
+    size_t reads = 0;
+    size_t writes = 0;
+
+    void operator()(const uint64_t addr, const bool write)
+    {
+        if (write) ++writes;
+        else ++reads;
+        if (writer) writer->transaction(addr, write);
+    }
+};
+
+/* ntt_access_stream sink: feeds the hierarchy line by line and paces the trace writer */
+class cachesim_sink
+{
+public:
+    size_t element = 32;
+    size_t gap = 1;
+    size_t compute_cycles = 20;
+    size_t accesses = 0;
+
+    cachesim_sink(cache_hierarchy& caches, cachesim_memory& memory) : caches(caches), memory(memory) {}
+
+    bool stage(const std::string&) { return true; }
+
+    void thread(const size_t t) { current = t; }
+
+    void access(const uint64_t addr, const bool write)
+    {
+        const size_t line = caches.line_size();
+        for (uint64_t l = addr / line; l <= (addr + element - 1) / line; ++l) {
+            if (memory.writer) memory.writer->tick(gap);
+            ++accesses;
+            caches.access(current, l * line, write, memory);
+        }
+    }
+
+    void compute()
+    {
+        if (memory.writer) memory.writer->tick(compute_cycles);
+    }
+
+    bool done() const { return false; }
+
+private:
+    cache_hierarchy& caches;
+    cachesim_memory& memory;
+    size_t current = 0;
+};
+
+int main(int argc, char* argv[]) {
+    int opt;
+    ntt_access_params params;
+    std::vector<ntt_access_kernel> kernels;
+    std::string spec = "L1:32K:8,L2:1M:16,LLC:32M:16";
+    std::string output;
+    size_t line = 64;
+    size_t gap = 1;
+    size_t compute_cycles = 20;
+
+    while ((opt = getopt(argc, argv, "k:n:t:l:E:A:C:L:g:m:o:")) != -1) {
+        switch (opt) {
+            case 'k':
+                if (!parse_ntt_access_kernel(optarg, params.kernel)) {
+                    std::cerr << "[-] Unknown kernel " << optarg << " (serial|four_step|stockham|radix2)" << std::endl;
+                    return 1;
+                }
+                kernels.push_back(params.kernel);
+                break;
+            case 'n':
+                params.log_n = std::stoul(optarg);
+                break;
+            case 't':
+                params.threads = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'l':
+                params.lanes = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'E':
+                params.element = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'A':
+                params.base = std::stoull(optarg, nullptr, 0);
+                break;
+            case 'C':
+                spec = optarg;
+                break;
+            case 'L':
+                line = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'g':
+                gap = std::stoul(optarg);
+                break;
+            case 'm':
+                compute_cycles = std::stoul(optarg);
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-k kernel]... [-n k] [-t threads] [-l lanes] [-E element_bytes] [-A base]"
+                          << " [-C name:size:ways,...] [-L line_bytes] [-g gap] [-m compute_cycles] [-o file]" << std::endl;
+                return 1;
+        }
+    }
+    if (kernels.empty())
+        kernels = {ntt_access_kernel::serial, ntt_access_kernel::four_step, ntt_access_kernel::stockham, ntt_access_kernel::radix2};
+
+    std::vector<cache_level_config> configs;
+    if (!parse_cache_levels(spec, configs)) {
+        std::cerr << "[-] Invalid cache levels " << spec << " (expected name:size:ways,...)" << std::endl;
+        return 1;
+    }
+    if (!output.empty() && kernels.size() != 1) {
+        std::cerr << "[-] -o writes the trace of one kernel: give exactly one -k" << std::endl;
+        return 1;
+    }
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file.is_open()) {
+            std::cerr << "[-] Unable to open file " << output << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "[*] Caches " << spec << ", " << line << " byte lines" << std::endl;
+    for (const ntt_access_kernel kernel : kernels) {
+        params.kernel = kernel;
+        try {
+            cache_hierarchy caches(configs, line, params.threads);
+            dramsim_trace_writer writer(file);
+            cachesim_memory memory;
+            if (!output.empty()) memory.writer = &writer;
+
+            cachesim_sink sink(caches, memory);
+            sink.element = params.element;
+            sink.gap = gap;
+            sink.compute_cycles = compute_cycles;
+            ntt_access_stream(params, sink);
+
+            std::cout << "[i] " << ntt_access_kernel_name(kernel) << " 2^" << params.log_n << " x" << params.threads
+                      << " : " << sink.accesses << " line accesses" << std::endl;
+            for (size_t i = 0; i < caches.depth(); ++i) {
+                const cache_level_stats s = caches.stats(i);
+                const size_t demand = s.reads + s.writes;
+                std::cout << "\t - " << std::setw(_print_align - 8) << std::left << caches.config(i).name << std::right
+                          << std::setw(14) << demand << " accesses, hit rate " << std::fixed << std::setprecision(2)
+                          << std::setw(6) << (demand ? 100.0 * s.hits / demand : 0.0) << "%, "
+                          << s.writebacks_out << " writebacks" << std::endl;
+            }
+            const size_t traffic = memory.reads + memory.writes;
+            std::cout << "\t - " << std::setw(_print_align - 8) << std::left << "DRAM" << std::right
+                      << std::setw(14) << traffic << " transactions (" << memory.reads << " reads, " << memory.writes << " writes), "
+                      << std::setprecision(2) << (traffic * line) / (1024.0 * 1024.0) << " MiB, "
+                      << (sink.accesses ? 100.0 * traffic / sink.accesses : 0.0) << "% of the line accesses" << std::endl;
+            if (memory.writer)
+                std::cout << "[+] " << writer.written() << " transactions written to " << output << std::endl;
+        } catch (const InvalidSizeException& e) {
+            std::cerr << "[-] " << e.what() << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
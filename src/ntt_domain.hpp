@@ -0,0 +1,155 @@
+#ifndef NTT_DOMAIN_HPP
+#define NTT_DOMAIN_HPP
+
+#include <memory>
+
+#include <libfqfft/evaluation_domain/get_evaluation_domain.hpp>
+#include <libfqfft/tools/exceptions.hpp>
+
+#include "utils.hpp"
+#include "ntt.hpp"
+
+/* Domains follow the build like libfqfft's own: parallel when built with MULTICORE */
+#ifdef MULTICORE
+const bool ntt_domain_multicore = true;
+#else
+const bool ntt_domain_multicore = false;
+#endif
+
+/*
+ * libfqfft evaluation domain of the m-th roots of unity, m = 2^k, whose
+ * transforms run on an ntt_engine. It is a drop-in for basic_radix2_domain.
+ *  - the radix-2 engine keeps the twiddle tables of omega and omega^-1 from
+ *    construction, so a transform is only the butterflies
+ *  - the coset twist g^i, the 1/m of the inverse and the untwist g^-i ride on
+ *    the first or last Stockham stage, or on one scaling pass otherwise
+ *    (icosetFFT scales once by (1/m) g^-i instead of twice)
+ */
+template<typename FieldT>
+class ntt_radix2_domain : public evaluation_domain<FieldT>
+{
+public:
+    FieldT omega;
+
+    ntt_radix2_domain(const size_t m, const ntt_engine engine = ntt_engine::radix2, const bool multicore = ntt_domain_multicore)
+        : evaluation_domain<FieldT>(m), engine(engine), multicore(multicore)
+    {
+        if (m <= 1) throw InvalidSizeException("ntt_radix2_domain(): expected m > 1");
+        if (!libff::is_power_of_2(m)) throw DomainSizeException("ntt_radix2_domain(): expected a power-of-two m");
+        if (libff::log2(m) > FieldT::s) throw DomainSizeException("ntt_radix2_domain(): expected logm <= FieldT::s");
+
+        omega = libff::get_root_of_unity<FieldT>(m);
+        omega_inv = omega.inverse();
+        m_inv = FieldT(m).inverse();
+        if (engine == ntt_engine::radix2) {
+            if (multicore) {
+                ntt_powers_parallel(w, m / 2, omega);
+                ntt_powers_parallel(w_inv, m / 2, omega_inv);
+            } else {
+                ntt_powers(w, m / 2, omega);
+                ntt_powers(w_inv, m / 2, omega_inv);
+            }
+        }
+    }
+
+    void FFT(std::vector<FieldT>& a)
+    {
+        if (a.size() != this->m) throw DomainSizeException("ntt_radix2_domain: expected a.size() == this->m");
+        transform(a, false, ntt_twist<FieldT>(), ntt_twist<FieldT>());
+    }
+
+    void iFFT(std::vector<FieldT>& a)
+    {
+        if (a.size() != this->m) throw DomainSizeException("ntt_radix2_domain: expected a.size() == this->m");
+        transform(a, true, ntt_twist<FieldT>(), ntt_twist<FieldT>(m_inv, FieldT::one()));
+    }
+
+    void cosetFFT(std::vector<FieldT>& a, const FieldT& g)
+    {
+        if (a.size() != this->m) throw DomainSizeException("ntt_radix2_domain: expected a.size() == this->m");
+        transform(a, false, ntt_twist<FieldT>(FieldT::one(), g), ntt_twist<FieldT>());
+    }
+
+    void icosetFFT(std::vector<FieldT>& a, const FieldT& g)
+    {
+        if (a.size() != this->m) throw DomainSizeException("ntt_radix2_domain: expected a.size() == this->m");
+        transform(a, true, ntt_twist<FieldT>(), ntt_twist<FieldT>(m_inv, g.inverse()));
+    }
+
+    std::vector<FieldT> evaluate_all_lagrange_polynomials(const FieldT& t)
+    {
+        return _basic_radix2_evaluate_all_lagrange_polynomials(this->m, t);
+    }
+
+    FieldT get_domain_element(const size_t idx) { return omega^idx; }
+
+    FieldT compute_vanishing_polynomial(const FieldT& t) { return (t^this->m) - FieldT::one(); }
+
+    void add_poly_Z(const FieldT& coeff, std::vector<FieldT>& H)
+    {
+        if (H.size() != this->m + 1) throw DomainSizeException("ntt_radix2_domain: expected H.size() == this->m+1");
+        H[this->m] += coeff;
+        H[0] -= coeff;
+    }
+
+    /* Z is the constant g^m - 1 on the whole coset, g = multiplicative_generator as in libfqfft */
+    void divide_by_Z_on_coset(std::vector<FieldT>& P)
+    {
+        const FieldT Z_inverse_at_coset = compute_vanishing_polynomial(FieldT::multiplicative_generator).inverse();
+        scale(P, ntt_twist<FieldT>(Z_inverse_at_coset, FieldT::one()));
+    }
+
+private:
+    ntt_engine engine;
+    bool multicore;
+    FieldT omega_inv;
+    FieldT m_inv;
+    std::vector<FieldT> w;
+    std::vector<FieldT> w_inv;
+
+    void scale(std::vector<FieldT>& a, const ntt_twist<FieldT>& twist) const
+    {
+        if (twist.is_identity()) return;
+        if (multicore) twisted_copy_parallel(a, a, this->m, twist);
+        else twisted_copy_serial(a, a, this->m, twist);
+    }
+
+    void transform(std::vector<FieldT>& a, const bool inverse, const ntt_twist<FieldT>& pre, const ntt_twist<FieldT>& post) const
+    {
+        const FieldT& root = inverse ? omega_inv : omega;
+        if (engine == ntt_engine::stockham) {
+            std::vector<FieldT> work;
+            if (multicore) stockham_parallel_ntt(a, work, root, pre, post);
+            else stockham_serial_ntt(a, work, root, pre, post);
+            return;
+        }
+
+        scale(a, pre);
+        if (engine == ntt_engine::radix2) {
+            FieldT* x[1] = { a.data() };
+            radix2_ntt_lanes(x, 1, this->m, inverse ? w_inv : w, multicore);
+        } else {
+            if (multicore) _basic_parallel_radix2_FFT(a, root);
+            else _basic_serial_radix2_FFT(a, root);
+        }
+        scale(a, post);
+    }
+};
+
+/*
+ * get_evaluation_domain with the same choice of domain, except that a basic
+ * radix-2 pick comes back as an ntt_radix2_domain of that size. libfqfft's
+ * selection has no registration hook, so callers switch to this factory.
+ */
+template<typename FieldT>
+std::shared_ptr<evaluation_domain<FieldT> > get_ntt_evaluation_domain(const size_t min_size,
+                                                                      const ntt_engine engine = ntt_engine::radix2,
+                                                                      const bool multicore = ntt_domain_multicore)
+{
+    std::shared_ptr<evaluation_domain<FieldT> > domain = get_evaluation_domain<FieldT>(min_size);
+    if (std::dynamic_pointer_cast<basic_radix2_domain<FieldT> >(domain))
+        domain = std::make_shared<ntt_radix2_domain<FieldT> >(domain->m, engine, multicore);
+    return domain;
+}
+
+#endif // NTT_DOMAIN_HPP
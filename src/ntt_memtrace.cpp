@@ -0,0 +1,184 @@
+#include <map>
+
+#include "utils.hpp"
+#include "ntt_access.hpp"
+#include "dramsim_trace.hpp"
+
+/*
+ * NTT address trace in the DRAMSim3 trace format (test/DRAMSim/example.trace):
+ * one "0xADDR READ|WRITE cycle" line per memory transaction.
+ *
+ * Element accesses are split into the cache lines they touch, and a line that
+ * repeats the previous transaction is dropped. Each transaction advances the
+ * clock by the issue gap and each butterfly by its compute cycles, so the
+ * cycle column keeps the kernel's pacing. To keep large transforms
+ * manageable the stream can be limited to some stages, and the writer can
+ * keep a window of transactions and sample one in k.
+ */
+
+struct trace_stage_count
+{
+    size_t transactions = 0;
+    size_t written = 0;
+};
+
+/* ntt_access_stream sink: splits element accesses into lines and paces them into the writer */
+class memtrace_sink
+{
+public:
+    size_t element = 32;
+    size_t line = 64;
+    size_t gap = 1;
+    size_t compute_cycles = 20;
+    std::vector<std::string> stages;    // empty: every stage
+
+    std::vector<std::string> order;
+    std::map<std::string, trace_stage_count> counts;
+
+    explicit memtrace_sink(dramsim_trace_writer& writer) : writer(writer) {}
+
+    /* Stages left out are not enumerated at all, which is what makes one stage of 2^27 quick */
+    bool stage(const std::string& name)
+    {
+        bool selected = stages.empty();
+        for (const auto& s : stages)
+            if (name.compare(0, s.size(), s) == 0 && (name.size() == s.size() || name[s.size()] == ' ')) selected = true;
+        if (!selected) return false;
+        if (counts.find(name) == counts.end()) order.push_back(name);
+        current = &counts[name];
+        return true;
+    }
+
+    void thread(const size_t) {}
+
+    void access(const uint64_t addr, const bool write)
+    {
+        if (line == 0) {
+            transaction(addr, write);
+            return;
+        }
+        for (uint64_t l = addr / line; l <= (addr + element - 1) / line; ++l) transaction(l * line, write);
+    }
+
+    void compute() { writer.tick(compute_cycles); }
+
+    bool done() const { return writer.done(); }
+
+private:
+    dramsim_trace_writer& writer;
+    trace_stage_count* current = nullptr;
+    uint64_t last_addr = ~uint64_t(0);
+    bool last_write = false;
+
+    void transaction(const uint64_t addr, const bool write)
+    {
+        if (addr == last_addr && write == last_write) return;
+        last_addr = addr;
+        last_write = write;
+        writer.tick(gap);
+        ++current->transactions;
+
+        const size_t before = writer.written();
+        writer.transaction(addr, write);
+        current->written += writer.written() - before;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    int opt;
+    ntt_access_params params;
+    std::string output;
+    size_t line = 64;
+    size_t gap = 1;
+    size_t compute_cycles = 20;
+    size_t sample = 1;
+    size_t window_begin = 0;
+    size_t window_count = 0;
+    std::vector<std::string> stages;
+
+    while ((opt = getopt(argc, argv, "k:n:t:l:E:A:L:g:m:s:w:c:S:o:")) != -1) {
+        switch (opt) {
+            case 'k':
+                if (!parse_ntt_access_kernel(optarg, params.kernel)) {
+                    std::cerr << "[-] Unknown kernel " << optarg << " (serial|four_step|stockham|radix2)" << std::endl;
+                    return 1;
+                }
+                break;
+            case 'n':
+                params.log_n = std::stoul(optarg);
+                break;
+            case 't':
+                params.threads = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'l':
+                params.lanes = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'E':
+                params.element = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'A':
+                params.base = std::stoull(optarg, nullptr, 0);
+                break;
+            case 'L':
+                line = std::stoul(optarg);
+                break;
+            case 'g':
+                gap = std::stoul(optarg);
+                break;
+            case 'm':
+                compute_cycles = std::stoul(optarg);
+                break;
+            case 's':
+                sample = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'w':
+                window_begin = std::stoul(optarg);
+                break;
+            case 'c':
+                window_count = std::stoul(optarg);
+                break;
+            case 'S':
+                stages.push_back(optarg);
+                break;
+            case 'o':
+                output = optarg;
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-k kernel] [-n k] [-t threads] [-l lanes] [-E element_bytes] [-A base]"
+                          << " [-L line_bytes] [-g gap] [-m compute_cycles] [-s sample] [-w first] [-c count] [-S stage]... [-o file]" << std::endl;
+                return 1;
+        }
+    }
+
+    std::ofstream file;
+    if (!output.empty()) {
+        file.open(output);
+        if (!file.is_open()) {
+            std::cerr << "[-] Unable to open file " << output << std::endl;
+            return 1;
+        }
+    }
+
+    dramsim_trace_writer writer(output.empty() ? std::cout : file);
+    writer.sample = sample;
+    writer.window_begin = window_begin;
+    writer.window_count = window_count;
+
+    memtrace_sink sink(writer);
+    sink.element = params.element;
+    sink.line = line;
+    sink.gap = gap;
+    sink.compute_cycles = compute_cycles;
+    sink.stages = stages;
+    ntt_access_stream(params, sink);
+
+    std::cerr << "[i] " << ntt_access_kernel_name(params.kernel) << " 2^" << params.log_n << " x" << params.threads
+              << " : " << writer.written() << " transactions written" << (writer.done() ? " (window reached)" : "") << std::endl;
+    for (const auto& name : sink.order) {
+        const trace_stage_count& c = sink.counts[name];
+        if (c.transactions == 0) continue;
+        std::cerr << "\t - " << std::setw(_print_align - 8) << std::left << name << std::right
+                  << std::setw(14) << c.transactions << " transactions, " << c.written << " written" << std::endl;
+    }
+    return 0;
+}
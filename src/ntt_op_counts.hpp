@@ -0,0 +1,95 @@
+#ifndef NTT_OP_COUNTS_HPP
+#define NTT_OP_COUNTS_HPP
+
+#include <sched.h>
+#include <omp.h>
+
+#include "utils.hpp"
+
+/*
+ * Fr operation counts from libff's own hooks: built with -DPROFILE_OP_COUNTS
+ * (cmake -DNTT_OP_COUNTS=ON), every FieldT +, -, *, squaring and inversion
+ * bumps a static counter of the field (exponentiation with ^ counts its
+ * multiplications too). Without it the counts read as zero and
+ * ntt_op_counting is false.
+ *
+ * libff's counters are plain shared increments, so a count is exact only when
+ * no two threads run at the same time; ntt_count_ops runs a parallel kernel
+ * with its team kept whole but pinned to one CPU.
+ */
+
+struct ntt_op_counts
+{
+    long long add = 0;
+    long long sub = 0;
+    long long mul = 0;
+    long long sqr = 0;
+    long long inv = 0;
+
+    ntt_op_counts operator-(const ntt_op_counts& other) const
+    {
+        ntt_op_counts d;
+        d.add = add - other.add;
+        d.sub = sub - other.sub;
+        d.mul = mul - other.mul;
+        d.sqr = sqr - other.sqr;
+        d.inv = inv - other.inv;
+        return d;
+    }
+
+    ntt_op_counts& operator+=(const ntt_op_counts& other)
+    {
+        add += other.add;
+        sub += other.sub;
+        mul += other.mul;
+        sqr += other.sqr;
+        inv += other.inv;
+        return *this;
+    }
+};
+
+#ifdef PROFILE_OP_COUNTS
+const bool ntt_op_counting = true;
+
+inline ntt_op_counts ntt_read_op_counts()
+{
+    ntt_op_counts c;
+    c.add = FieldT::add_cnt;
+    c.sub = FieldT::sub_cnt;
+    c.mul = FieldT::mul_cnt;
+    c.sqr = FieldT::sqr_cnt;
+    c.inv = FieldT::inv_cnt;
+    return c;
+}
+#else
+const bool ntt_op_counting = false;
+
+inline ntt_op_counts ntt_read_op_counts() { return ntt_op_counts(); }
+#endif // PROFILE_OP_COUNTS
+
+/* Operations done by f(), with every thread of a `threads` team sharing the caller's CPU meanwhile */
+template<typename F>
+ntt_op_counts ntt_count_ops(const size_t threads, F f)
+{
+    cpu_set_t one;
+    CPU_ZERO(&one);
+    CPU_SET(sched_getcpu(), &one);
+
+    std::vector<cpu_set_t> saved(threads);
+    #pragma omp parallel num_threads(threads)
+    {
+        sched_getaffinity(0, sizeof(cpu_set_t), &saved[omp_get_thread_num()]);
+        sched_setaffinity(0, sizeof(cpu_set_t), &one);
+    }
+
+    const ntt_op_counts before = ntt_read_op_counts();
+    f();
+    const ntt_op_counts after = ntt_read_op_counts();
+
+    #pragma omp parallel num_threads(threads)
+    sched_setaffinity(0, sizeof(cpu_set_t), &saved[omp_get_thread_num()]);
+
+    return after - before;
+}
+
+#endif // NTT_OP_COUNTS_HPP
@@ -0,0 +1,227 @@
+#ifndef NTT_PROFILE_HPP
+#define NTT_PROFILE_HPP
+
+/*
+ * Per-stage NTT instrumentation, built with -DNTT_PROFILE (cmake -DNTT_PROFILE=ON).
+ * Without it every macro below expands to nothing.
+ *
+ * A kernel marks where each of its stages begins with NTT_PROFILE_STAGE and
+ * closes the last one with NTT_PROFILE_STOP. Every thread that runs a stage
+ * marks it itself, so inside a parallel region the marks go right after the
+ * barrier that ends the previous stage; kernels that open one parallel region
+ * per stage use the _TEAM variants, which mark on every thread of the team.
+ * A stage records wall time on thread 0 and, per thread, cycles,
+ * instructions, LLC read misses and dTLB read misses from perf_event_open,
+ * summed over the threads. Counters the kernel refuses (perf_event_paranoid,
+ * no PMU in a VM) are reported as "-". In an op-count build (ntt_op_counts.hpp)
+ * thread 0 also records the Fr operations of all threads between its marks.
+ */
+
+#ifdef NTT_PROFILE
+
+#include <chrono>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <ostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <omp.h>
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+
+#include "ntt_op_counts.hpp"
+
+const size_t ntt_profile_counters = 4;
+
+/* The calling thread's counters, user space only, free running from open */
+struct ntt_thread_counters
+{
+    int fd[ntt_profile_counters];
+
+    ntt_thread_counters()
+    {
+        const unsigned long long cache_read_miss = (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        const unsigned int types[ntt_profile_counters] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HW_CACHE, PERF_TYPE_HW_CACHE };
+        const unsigned long long configs[ntt_profile_counters] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_LL | cache_read_miss,
+            PERF_COUNT_HW_CACHE_DTLB | cache_read_miss
+        };
+
+        for (size_t i = 0; i < ntt_profile_counters; ++i) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = types[i];
+            attr.config = configs[i];
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+            fd[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+        }
+    }
+
+    ~ntt_thread_counters()
+    {
+        for (size_t i = 0; i < ntt_profile_counters; ++i)
+            if (fd[i] >= 0) close(fd[i]);
+    }
+
+    void read_all(unsigned long long (&v)[ntt_profile_counters]) const
+    {
+        for (size_t i = 0; i < ntt_profile_counters; ++i)
+            if (fd[i] < 0 || read(fd[i], &v[i], sizeof(v[i])) != sizeof(v[i])) v[i] = 0;
+    }
+};
+
+struct ntt_stage_totals
+{
+    std::string name;
+    unsigned long long calls = 0;
+    unsigned long long wall_ns = 0;
+    unsigned long long counts[ntt_profile_counters] = {};
+    bool valid[ntt_profile_counters] = {};
+    ntt_op_counts ops;
+};
+
+/* Stages in first-seen order, shared by all threads */
+struct ntt_profile_table
+{
+    std::mutex lock;
+    std::vector<ntt_stage_totals> stages;
+    std::map<std::pair<std::string, long>, size_t> index;
+};
+
+inline ntt_profile_table& ntt_profile_tables()
+{
+    static ntt_profile_table table;
+    return table;
+}
+
+/* The stage the calling thread is in, if any */
+struct ntt_thread_stage
+{
+    ntt_thread_counters counters;
+    const char* name = nullptr;
+    long stage = -1;
+    unsigned long long start[ntt_profile_counters];
+    std::chrono::steady_clock::time_point start_time;
+    ntt_op_counts start_ops;
+};
+
+inline ntt_thread_stage& ntt_profile_thread()
+{
+    thread_local ntt_thread_stage state;
+    return state;
+}
+
+inline void ntt_profile_stop()
+{
+    ntt_thread_stage& t = ntt_profile_thread();
+    if (t.name == nullptr) return;
+
+    unsigned long long end[ntt_profile_counters];
+    t.counters.read_all(end);
+    const auto end_time = std::chrono::steady_clock::now();
+    const ntt_op_counts end_ops = ntt_read_op_counts();
+    const bool master = (omp_get_thread_num() == 0);
+
+    ntt_profile_table& table = ntt_profile_tables();
+    std::lock_guard<std::mutex> guard(table.lock);
+    const auto key = std::make_pair(std::string(t.name), t.stage);
+    auto it = table.index.find(key);
+    if (it == table.index.end()) {
+        it = table.index.emplace(key, table.stages.size()).first;
+        table.stages.emplace_back();
+        table.stages.back().name = t.stage < 0 ? key.first : key.first + " " + std::to_string(t.stage);
+    }
+    ntt_stage_totals& s = table.stages[it->second];
+    if (master) {
+        s.calls += 1;
+        s.wall_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - t.start_time).count();
+        s.ops += end_ops - t.start_ops;
+    }
+    for (size_t i = 0; i < ntt_profile_counters; ++i) {
+        if (t.counters.fd[i] < 0) continue;
+        s.counts[i] += end[i] - t.start[i];
+        s.valid[i] = true;
+    }
+    t.name = nullptr;
+}
+
+/* Close the calling thread's current stage and open `name` (numbered by `stage` unless it is negative) */
+inline void ntt_profile_stage(const char* name, const long stage)
+{
+    ntt_profile_stop();
+    ntt_thread_stage& t = ntt_profile_thread();
+    t.name = name;
+    t.stage = stage;
+    t.start_time = std::chrono::steady_clock::now();
+    t.counters.read_all(t.start);
+    t.start_ops = ntt_read_op_counts();
+}
+
+inline void ntt_profile_reset()
+{
+    ntt_profile_table& table = ntt_profile_tables();
+    std::lock_guard<std::mutex> guard(table.lock);
+    table.stages.clear();
+    table.index.clear();
+}
+
+inline void ntt_profile_report(std::ostream& out)
+{
+    ntt_profile_table& table = ntt_profile_tables();
+    std::lock_guard<std::mutex> guard(table.lock);
+    if (table.stages.empty()) return;
+
+    const char* headers[ntt_profile_counters] = { "cycles", "instr", "LLC miss", "dTLB miss" };
+    out << "[i] NTT Stage Profile" << std::endl;
+    out << std::setw(36) << std::left << "\t - stage" << std::right << std::setw(8) << "calls" << std::setw(12) << "wall(us)";
+    for (size_t i = 0; i < ntt_profile_counters; ++i) out << std::setw(14) << headers[i];
+    out << std::setw(7) << "IPC";
+    if (ntt_op_counting)
+        out << std::setw(14) << "mul" << std::setw(12) << "sqr" << std::setw(14) << "add" << std::setw(14) << "sub" << std::setw(8) << "inv";
+    out << std::endl;
+
+    for (const auto& s : table.stages) {
+        out << std::setw(36) << std::left << "\t - " + s.name << std::right << std::setw(8) << s.calls
+            << std::setw(12) << s.wall_ns / 1000;
+        for (size_t i = 0; i < ntt_profile_counters; ++i) {
+            if (s.valid[i]) out << std::setw(14) << s.counts[i];
+            else out << std::setw(14) << "-";
+        }
+        if (s.valid[0] && s.valid[1] && s.counts[0] > 0)
+            out << std::setw(7) << std::fixed << std::setprecision(2) << static_cast<double>(s.counts[1]) / s.counts[0] << std::defaultfloat;
+        else
+            out << std::setw(7) << "-";
+        if (ntt_op_counting)
+            out << std::setw(14) << s.ops.mul << std::setw(12) << s.ops.sqr << std::setw(14) << s.ops.add
+                << std::setw(14) << s.ops.sub << std::setw(8) << s.ops.inv;
+        out << std::endl;
+    }
+}
+
+#define NTT_PROFILE_STAGE(name, stage) ntt_profile_stage(name, stage)
+#define NTT_PROFILE_STOP() ntt_profile_stop()
+#define NTT_PROFILE_TEAM_STAGE(name, stage) do { _Pragma("omp parallel") ntt_profile_stage(name, stage); } while (0)
+#define NTT_PROFILE_TEAM_STOP() do { _Pragma("omp parallel") ntt_profile_stop(); } while (0)
+#define NTT_PROFILE_REPORT(out) ntt_profile_report(out)
+#define NTT_PROFILE_RESET() ntt_profile_reset()
+
+#else
+
+#define NTT_PROFILE_STAGE(name, stage) ((void)0)
+#define NTT_PROFILE_STOP() ((void)0)
+#define NTT_PROFILE_TEAM_STAGE(name, stage) ((void)0)
+#define NTT_PROFILE_TEAM_STOP() ((void)0)
+#define NTT_PROFILE_REPORT(out) ((void)0)
+#define NTT_PROFILE_RESET() ((void)0)
+
+#endif // NTT_PROFILE
+
+#endif // NTT_PROFILE_HPP
@@ -1,4 +1,5 @@
 #include "utils.hpp"
+#include "ntt.hpp"
 
 template <typename FieldT>
 void generate_polynomial_to_file(const std::string& filename, size_t degree)
@@ -39,104 +40,6 @@ void generate_polynomial_to_file(const std::string& filename, size_t degree)
     }
 }
 
-// Code from libff
-template<typename FieldT>
-void baseline_serial_ntt(std::vector<FieldT> &a, const FieldT &omega)
-{
-    const size_t n = a.size(), logn = log2(n);
-    if (n != (1u << logn)) throw DomainSizeException("expected n == (1u << logn)");
-
-    /* swapping in place (from Storer's book) */
-    for (size_t k = 0; k < n; ++k)
-    {
-        const size_t rk = libff::bitreverse(k, logn);
-        if (k < rk)
-            std::swap(a[k], a[rk]);
-    }
-
-    size_t m = 1; // invariant: m = 2^{s-1}
-    for (size_t s = 1; s <= logn; ++s)
-    {
-        // w_m is 2^s-th root of unity now
-        const FieldT w_m = omega^(n/(2*m));
-
-        asm volatile  ("/* pre-inner */");
-        for (size_t k = 0; k < n; k += 2*m)
-        {
-            FieldT w = FieldT::one();
-            for (size_t j = 0; j < m; ++j)
-            {
-                const FieldT t = w * a[k+j+m];
-                a[k+j+m] = a[k+j] - t;
-                a[k+j] += t;
-                w *= w_m;
-            }
-        }
-        asm volatile ("/* post-inner */");
-        m *= 2;
-    }
-}
-
-template<typename FieldT>
-void baseline_parallel_ntt(std::vector<FieldT> &a, const FieldT &omega, const size_t log_cpus)
-{
-    const size_t num_cpus = 1ul<<log_cpus;
-
-    const size_t m = a.size();
-    const size_t log_m = log2(m);
-    if (m != 1ul<<log_m) throw DomainSizeException("expected m == 1ul<<log_m");
-
-    if (log_m < log_cpus)
-    {
-        _basic_serial_radix2_FFT(a, omega);
-        return;
-    }
-
-    std::vector<std::vector<FieldT> > tmp(num_cpus);
-    for (size_t j = 0; j < num_cpus; ++j)
-    {
-        tmp[j].resize(1ul<<(log_m-log_cpus), FieldT::zero());
-    }
-
-    #pragma omp parallel for
-    for (size_t j = 0; j < num_cpus; ++j)
-    {
-        const FieldT omega_j = omega^j;
-        const FieldT omega_step = omega^(j<<(log_m - log_cpus));
-
-        FieldT elt = FieldT::one();
-        for (size_t i = 0; i < 1ul<<(log_m - log_cpus); ++i)
-        {
-            for (size_t s = 0; s < num_cpus; ++s)
-            {
-                // invariant: elt is omega^(j*idx)
-                const size_t idx = (i + (s<<(log_m - log_cpus))) % (1u << log_m);
-                tmp[j][i] += a[idx] * elt;
-                elt *= omega_step;
-            }
-            elt *= omega_j;
-        }
-    }
-
-    const FieldT omega_num_cpus = omega^num_cpus;
-
-    #pragma omp parallel for
-    for (size_t j = 0; j < num_cpus; ++j)
-    {
-        _basic_serial_radix2_FFT(tmp[j], omega_num_cpus);
-    }
-
-    #pragma omp parallel for
-    for (size_t i = 0; i < num_cpus; ++i)
-    {
-        for (size_t j = 0; j < 1ul<<(log_m - log_cpus); ++j)
-        {
-            // now: i = idx >> (log_m - log_cpus) and j = idx % (1u << (log_m - log_cpus)), for idx = ((i<<(log_m-log_cpus))+j) % (1u << log_m)
-            a[(j<<log_cpus) + i] = tmp[i][j];
-        }
-    }
-}
-
 int test(int k) {
     size_t degree = 1 << k;
 
@@ -149,8 +52,6 @@ int test(int k) {
 
     // Read Polynomial & Print Parameter
     std::vector<FieldT> a;
-    std::vector<FieldT> v(a);
-    std::vector<FieldT> u(a);
     bls12_381_pp::init_public_params();
     generate_polynomial_to_file("data/input_a_2.txt", degree);
     if(!read_polynomial("data/input_a_2.txt", a)) return 1;
@@ -161,8 +62,15 @@ int test(int k) {
     std::cout << "\t - Omega : 0x" << std::hex << omega << std::endl;
     std::cout << "\t - O_inv : 0x" << std::hex << omega.inverse() << std::endl;
 
+    std::vector<FieldT> v(a);
+    std::vector<FieldT> u(a);
+    std::vector<FieldT> x(a);
+    std::vector<FieldT> y(a);
+    std::vector<FieldT> work;
     u.resize(n, FieldT::zero());
     v.resize(n, FieldT::zero());
+    x.resize(n, FieldT::zero());
+    y.resize(n, FieldT::zero());
     // Serial Timing Measure
     {
     std::cout << "[*] processing Serial FFT";
@@ -196,20 +104,250 @@ int test(int k) {
     std::cout << std::setw(_print_align) << std::left << "\r[+] Parallel process complete"
               << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
     }
+
+    // Stockham Serial Timing Measure
+    {
+    std::cout << "[*] processing Stockham Serial FFT";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    stockham_serial_ntt(x, work, omega);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Stockham Serial process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    // Stockham Parallel Timing Measure
+    {
+    std::cout << "[*] processing Stockham Parallel FFT";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    stockham_parallel_ntt(y, work, omega);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Stockham Parallel process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
     
     if (v != u) std::cout << "Serial and Parallel Results are different" << std::endl;
+    if (v != x) std::cout << "Serial and Stockham Serial Results are different" << std::endl;
+    if (v != y) std::cout << "Serial and Stockham Parallel Results are different" << std::endl;
 
     if(!write_polynomial("data/output_a_ntt.txt", u)) return 1;
 
     return 0;
 }
 
-int main(){
-    int i;
+/*
+ * Forward transforms of two operands: back to back with libfqfft and with the
+ * radix-2 kernel, then as two lanes of one radix-2 pass. The speedup that
+ * isolates the pairing (shared twiddles, one barrier per stage) is paired
+ * against sequential radix-2; against libfqfft it also includes the kernel.
+ */
+int test_pair(int k) {
+    size_t degree = 1 << k;
+
+    const size_t num_cpus = omp_get_max_threads();
+    std::cout << "[i] Mode : Parallel (operand pair)" << std::endl;
+    std::cout << "\t- num_cpus : " << num_cpus << std::endl;
+
+    std::vector<FieldT> a;
+    std::vector<FieldT> b;
+    bls12_381_pp::init_public_params();
+    generate_polynomial_to_file("data/input_a_2.txt", degree);
+    generate_polynomial_to_file("data/input_b_2.txt", degree);
+    if(!read_polynomial("data/input_a_2.txt", a)) return 1;
+    if(!read_polynomial("data/input_b_2.txt", b)) return 1;
+    const size_t n = libff::get_power_of_two(a.size());
+    FieldT omega = libff::get_root_of_unity<FieldT>(n);
+    std::cout << "[i] NTT Parameter" << std::endl;
+    std::cout << "\t - Polynomial Size : " << "2^" <<  log2(n) << std::endl;
+
+    std::vector<FieldT> u(a);
+    std::vector<FieldT> v(b);
+    std::vector<FieldT> p(a);
+    std::vector<FieldT> q(b);
+    std::vector<FieldT> x(a);
+    std::vector<FieldT> y(b);
+    u.resize(n, FieldT::zero());
+    v.resize(n, FieldT::zero());
+    p.resize(n, FieldT::zero());
+    q.resize(n, FieldT::zero());
+    x.resize(n, FieldT::zero());
+    y.resize(n, FieldT::zero());
+
+    std::chrono::milliseconds sequential_time;
+    std::chrono::milliseconds radix2_time;
+    std::chrono::milliseconds paired_time;
+
+    // Back-to-back Timing Measure
+    {
+    std::cout << "[*] processing Sequential Pair FFT";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    _basic_parallel_radix2_FFT(u, omega);
+    _basic_parallel_radix2_FFT(v, omega);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+    sequential_time = duration;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Sequential Pair process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    // Back-to-back Radix-2 Timing Measure
+    {
+    std::cout << "[*] processing Sequential Radix-2 FFT";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    radix2_parallel_ntt(p, omega);
+    radix2_parallel_ntt(q, omega);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+    radix2_time = duration;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Sequential Radix-2 process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    // Two-lane Timing Measure
+    {
+    std::cout << "[*] processing Paired Radix-2 FFT";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    radix2_ntt_pair(x, y, omega, true);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+    paired_time = duration;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Paired Radix-2 process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    if (u != x || v != y) std::cout << "Sequential and Paired Results are different" << std::endl;
+    if (p != x || q != y) std::cout << "Sequential Radix-2 and Paired Results are different" << std::endl;
+    if (paired_time.count() > 0) {
+        std::cout << "[i] Speedup" << std::fixed << std::setprecision(2) << std::endl;
+        std::cout << "\t - Paired vs Sequential Radix-2 : " << static_cast<double>(radix2_time.count()) / paired_time.count() << "x" << std::endl;
+        std::cout << "\t - Paired vs Sequential libfqfft : " << static_cast<double>(sequential_time.count()) / paired_time.count() << "x" << std::endl;
+        std::cout << std::defaultfloat;
+    }
+
+    return 0;
+}
+
+/* n separate inverse() calls against one batch_inverse pass */
+int test_inverse(int k) {
+    size_t degree = 1 << k;
+
+    const size_t num_cpus = omp_get_max_threads();
+    std::cout << "[i] Mode : Parallel (batch inversion)" << std::endl;
+    std::cout << "\t- num_cpus : " << num_cpus << std::endl;
+
+    bls12_381_pp::init_public_params();
+    std::vector<FieldT> a(degree);
+    for (auto& x : a) x = FieldT::random_element();
+
+    std::vector<FieldT> u(a);
+    std::vector<FieldT> v(a);
+
+    // Element-wise Timing Measure
+    {
+    std::cout << "[*] processing Element-wise Inverse";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    #pragma omp parallel for
+    for (size_t i = 0; i < degree; ++i) u[i] = u[i].inverse();
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Element-wise Inverse process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    // Batch Timing Measure
+    {
+    std::cout << "[*] processing Batch Inverse";
+    std::cout.flush();
+    auto start_time = std::chrono::high_resolution_clock::now();
+    batch_inverse(v, true);
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
+
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Batch Inverse process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+    }
+
+    if (u != v) std::cout << "Element-wise and Batch Results are different" << std::endl;
+
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int opt;
+    std::vector<int> sizes;
+    bool pair = false;
+    bool inverse = false;
+
+    while ((opt = getopt(argc, argv, "n:pi")) != -1) {
+        switch (opt) {
+            case 'n':
+                sizes.push_back(std::stoi(optarg));
+                break;
+            case 'p':
+                pair = true;
+                break;
+            case 'i':
+                inverse = true;
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-p|-i] [-n k]..." << std::endl;
+                return 1;
+        }
+    }
+
+    /* Default sweep: fits in L2 (2^15 * 32B = 1MB), fits in LLC (2^20 = 32MB), DRAM-bound (2^27 = 4GB) */
+    if (sizes.empty() && inverse) sizes = {16, 20};
+    if (sizes.empty() && pair) sizes = {20, 21, 22, 23, 24, 25, 26, 27};
+    if (sizes.empty()) sizes = {15, 20, 27};
 
-    for(i = 27; i < 28; i++) {
+    for (int i : sizes) {
         std::cout << "# Test " << i << std::endl;
-        test(i);
+        if (inverse) test_inverse(i);
+        else if (pair) test_pair(i);
+        else test(i);
+        NTT_PROFILE_REPORT(std::cout);
+        NTT_PROFILE_RESET();
         std::cout << std::endl;
     }
 
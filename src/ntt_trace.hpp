@@ -0,0 +1,221 @@
+#ifndef NTT_TRACE_HPP
+#define NTT_TRACE_HPP
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <omp.h>
+
+/*
+ * Timeline of thread activity in the parallel NTT and multiplication paths.
+ * With NTT_TRACE=file.json in the environment the process writes a Chrome
+ * trace (chrome://tracing, ui.perfetto.dev) to that file at exit, and prints
+ * every thread's busy / barrier / idle share of the traced regions to stderr.
+ * Without it a span costs one branch.
+ *
+ * A span is one of
+ *  - region  : a parallel region, recorded by the thread that opens it
+ *  - opaque  : a region whose threads are not traced (libfqfft, Stockham);
+ *              on the timeline, but left out of the busy / idle summary
+ *  - work    : a thread's share of a worksharing loop, or one iteration
+ *  - barrier : a thread waiting at a barrier
+ * Each thread appends to its own ring of ntt_trace_capacity events, so a
+ * long run keeps its most recent events.
+ */
+
+enum class ntt_trace_kind { region, opaque, work, barrier };
+
+const size_t ntt_trace_capacity = 1ul << 16;
+
+struct ntt_trace_event
+{
+    const char* name;
+    long arg;
+    ntt_trace_kind kind;
+    uint64_t begin_ns;
+    uint64_t end_ns;
+};
+
+struct ntt_trace_buffer
+{
+    size_t tid;
+    size_t pushed = 0;
+    std::vector<ntt_trace_event> events;
+
+    void push(const ntt_trace_event& e)
+    {
+        if (events.size() < ntt_trace_capacity) events.push_back(e);
+        else events[pushed % ntt_trace_capacity] = e;
+        ++pushed;
+    }
+};
+
+class ntt_trace_log
+{
+public:
+    static ntt_trace_log& get()
+    {
+        static ntt_trace_log log;
+        return log;
+    }
+
+    bool enabled() const { return !path.empty(); }
+
+    uint64_t now() const
+    {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count();
+    }
+
+    /* The calling thread's ring, registered on first use */
+    ntt_trace_buffer& thread_buffer()
+    {
+        thread_local ntt_trace_buffer* buffer = nullptr;
+        if (buffer == nullptr) {
+            std::lock_guard<std::mutex> guard(lock);
+            buffers.emplace_back(new ntt_trace_buffer());
+            buffer = buffers.back().get();
+            buffer->tid = buffers.size() - 1;
+        }
+        return *buffer;
+    }
+
+    ~ntt_trace_log()
+    {
+        if (!enabled()) return;
+        write_chrome_trace();
+        write_summary(std::cerr);
+    }
+
+private:
+    std::string path;
+    std::chrono::steady_clock::time_point epoch;
+    std::mutex lock;
+    std::vector<std::unique_ptr<ntt_trace_buffer> > buffers;
+
+    ntt_trace_log() : epoch(std::chrono::steady_clock::now())
+    {
+        const char* env = std::getenv("NTT_TRACE");
+        if (env != nullptr) path = env;
+    }
+
+    void write_chrome_trace() const
+    {
+        std::ofstream out(path);
+        if (!out.is_open()) {
+            std::cerr << "[-] Unable to open file " << path << std::endl;
+            return;
+        }
+
+        const char* categories[] = { "region", "opaque", "work", "barrier" };
+        size_t count = 0;
+        out << "{\"displayTimeUnit\": \"ns\", \"traceEvents\": [" << std::endl;
+        for (const auto& b : buffers) {
+            out << "  {\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, \"tid\": " << b->tid
+                << ", \"args\": {\"name\": \"thread " << b->tid << "\"}}," << std::endl;
+            for (const auto& e : b->events) {
+                out << "  {\"name\": \"" << e.name << "\", \"cat\": \"" << categories[static_cast<int>(e.kind)] << "\", \"ph\": \"X\""
+                    << ", \"ts\": " << e.begin_ns / 1000 << "." << std::setw(3) << std::setfill('0') << e.begin_ns % 1000
+                    << ", \"dur\": " << (e.end_ns - e.begin_ns) / 1000 << "." << std::setw(3) << (e.end_ns - e.begin_ns) % 1000
+                    << std::setfill(' ') << ", \"pid\": 1, \"tid\": " << b->tid;
+                if (e.arg >= 0) out << ", \"args\": {\"i\": " << e.arg << "}";
+                out << "}," << std::endl;
+                ++count;
+            }
+        }
+        /* Closing metadata event, so every event above can end with a comma */
+        out << "  {\"name\": \"process_name\", \"ph\": \"M\", \"pid\": 1, \"args\": {\"name\": \"ntt\"}}" << std::endl;
+        out << "]}" << std::endl;
+        std::cerr << "[i] NTT Trace : " << path << " (" << count << " events)" << std::endl;
+    }
+
+    /* Shares of the union of traced regions: work, barrier, and the rest as idle */
+    void write_summary(std::ostream& out) const
+    {
+        std::vector<std::pair<uint64_t, uint64_t> > regions;
+        for (const auto& b : buffers)
+            for (const auto& e : b->events)
+                if (e.kind == ntt_trace_kind::region) regions.emplace_back(e.begin_ns, e.end_ns);
+        std::sort(regions.begin(), regions.end());
+
+        uint64_t total = 0;
+        uint64_t covered = 0;
+        for (const auto& r : regions) {
+            const uint64_t begin = std::max(r.first, covered);
+            if (r.second > begin) total += r.second - begin;
+            covered = std::max(covered, r.second);
+        }
+        if (total == 0) return;
+
+        out << "[i] NTT Thread Activity (" << total / 1000 << " us in traced regions)" << std::endl;
+        for (const auto& b : buffers) {
+            uint64_t busy = 0;
+            uint64_t wait = 0;
+            for (const auto& e : b->events) {
+                if (e.kind == ntt_trace_kind::work) busy += e.end_ns - e.begin_ns;
+                else if (e.kind == ntt_trace_kind::barrier) wait += e.end_ns - e.begin_ns;
+            }
+            const double busy_pct = std::min(100.0, 100.0 * busy / total);
+            const double wait_pct = std::min(100.0 - busy_pct, 100.0 * wait / total);
+            out << "\t - thread " << b->tid << " : busy " << std::fixed << std::setprecision(1) << busy_pct
+                << "%, barrier " << wait_pct << "%, idle " << 100.0 - busy_pct - wait_pct << "%" << std::defaultfloat << std::endl;
+        }
+    }
+};
+
+/* Registers the calling thread and then the whole pool up front, so threads that never get work still show up as idle */
+inline bool ntt_trace_enabled()
+{
+    static const bool enabled = [] {
+        ntt_trace_log& log = ntt_trace_log::get();
+        if (!log.enabled()) return false;
+        log.thread_buffer();
+        #pragma omp parallel
+        log.thread_buffer();
+        return true;
+    }();
+    return enabled;
+}
+
+/* Records [construction, destruction) on the calling thread; a null name records nothing */
+class ntt_trace_span
+{
+public:
+    ntt_trace_span(const char* name, const ntt_trace_kind kind, const long arg = -1)
+        : name(ntt_trace_enabled() ? name : nullptr), kind(kind), arg(arg), begin_ns(0)
+    {
+        if (this->name != nullptr) begin_ns = ntt_trace_log::get().now();
+    }
+
+    ~ntt_trace_span()
+    {
+        if (name == nullptr) return;
+        ntt_trace_log& log = ntt_trace_log::get();
+        log.thread_buffer().push({name, arg, kind, begin_ns, log.now()});
+    }
+
+    ntt_trace_span(const ntt_trace_span&) = delete;
+    ntt_trace_span& operator=(const ntt_trace_span&) = delete;
+
+private:
+    const char* name;
+    ntt_trace_kind kind;
+    long arg;
+    uint64_t begin_ns;
+};
+
+/* Barrier of the enclosing parallel region, recorded as a wait when `traced` */
+inline void ntt_trace_barrier(const bool traced)
+{
+    ntt_trace_span wait(traced ? "barrier" : nullptr, ntt_trace_kind::barrier);
+    #pragma omp barrier
+}
+
+#endif // NTT_TRACE_HPP
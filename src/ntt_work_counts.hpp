@@ -0,0 +1,58 @@
+#ifndef NTT_WORK_COUNTS_HPP
+#define NTT_WORK_COUNTS_HPP
+
+#include <atomic>
+#include <cstddef>
+
+/*
+ * Transforms and full-array passes run so far. The kernels count one
+ * transform per vector they transform (a radix-3 size runs three), with its
+ * length, and the copy-in / twist, pointwise and radix-3 split and merge
+ * passes count one pass each, so a benchmark can report the work a pipeline
+ * actually did (expression_test) rather than assume it. The counters are
+ * relaxed atomics: batch jobs transform concurrently.
+ */
+
+struct ntt_work_counts
+{
+    size_t transforms = 0;
+    size_t elements = 0;    // summed transform lengths
+    size_t passes = 0;
+
+    ntt_work_counts operator-(const ntt_work_counts& other) const
+    {
+        ntt_work_counts d;
+        d.transforms = transforms - other.transforms;
+        d.elements = elements - other.elements;
+        d.passes = passes - other.passes;
+        return d;
+    }
+};
+
+inline std::atomic<size_t>* ntt_work_counters()
+{
+    static std::atomic<size_t> counters[3];
+    return counters;
+}
+
+inline void ntt_count_transforms(const size_t count, const size_t n)
+{
+    ntt_work_counters()[0].fetch_add(count, std::memory_order_relaxed);
+    ntt_work_counters()[1].fetch_add(count * n, std::memory_order_relaxed);
+}
+
+inline void ntt_count_pass()
+{
+    ntt_work_counters()[2].fetch_add(1, std::memory_order_relaxed);
+}
+
+inline ntt_work_counts ntt_read_work_counts()
+{
+    ntt_work_counts c;
+    c.transforms = ntt_work_counters()[0].load(std::memory_order_relaxed);
+    c.elements = ntt_work_counters()[1].load(std::memory_order_relaxed);
+    c.passes = ntt_work_counters()[2].load(std::memory_order_relaxed);
+    return c;
+}
+
+#endif // NTT_WORK_COUNTS_HPP
@@ -0,0 +1,292 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+
+#include "utils.hpp"
+#include "ntt.hpp"
+#include "polynomial_multiplication.hpp"
+
+/*
+ * Performance regression gate over the NTT kernels, polynomial multiplication
+ * (serial and parallel, every engine) and polynomial file I/O.
+ *
+ * -s records every case of a named configuration into a baseline file; -c
+ * times them again and compares. A case regresses when its median is slower
+ * than the baseline median by more than the threshold, widened to three
+ * times the measured noise of both runs, and a one-sided Mann-Whitney test
+ * says the slowdown is not chance (p < gate_alpha). Any regression makes the
+ * exit code nonzero.
+ */
+
+const double gate_alpha = 0.01;
+const char* gate_io_file = "data/perf_gate.bin";
+
+struct gate_case
+{
+    std::string name;
+    std::function<void()> setup;    // untimed, before every run
+    std::function<void()> run;
+};
+
+typedef std::map<std::string, std::vector<long long> > gate_samples;
+
+std::vector<gate_case> gate_cases(const std::vector<int>& sizes, std::vector<FieldT>& a, std::vector<FieldT>& b,
+                                  std::vector<FieldT>& x, std::vector<FieldT>& c, std::vector<FieldT>& work)
+{
+    const std::string threads = "x" + std::to_string(omp_get_max_threads());
+    const ntt_engine engines[] = { ntt_engine::libfqfft, ntt_engine::stockham, ntt_engine::radix2 };
+
+    std::vector<gate_case> cases;
+    for (int log_n : sizes) {
+        const size_t n = 1ul << log_n;
+        const std::string size = "2^" + std::to_string(log_n);
+        const FieldT omega = libff::get_root_of_unity<FieldT>(n);
+        auto fill = [&a, &b, n] {
+            if (a.size() == n) return;
+            a.resize(n);
+            b.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                a[i] = FieldT::random_element();
+                b[i] = FieldT::random_element();
+            }
+        };
+        auto copy_in = [&a, &x, fill] { fill(); x = a; };
+
+        const size_t num_cpus = omp_get_max_threads();
+        const size_t log_cpus = ((num_cpus & (num_cpus - 1)) == 0 ? log2(num_cpus) : log2(num_cpus) - 1);
+
+        cases.push_back({"ntt/serial/" + size, copy_in, [&x, omega] { baseline_serial_ntt(x, omega); }});
+        cases.push_back({"ntt/baseline_parallel/" + size + "/" + threads, copy_in, [&x, omega, log_cpus] { baseline_parallel_ntt(x, omega, log_cpus); }});
+        cases.push_back({"ntt/libfqfft_parallel/" + size + "/" + threads, copy_in, [&x, omega] { _basic_parallel_radix2_FFT(x, omega); }});
+        cases.push_back({"ntt/stockham_serial/" + size, copy_in, [&x, &work, omega] { stockham_serial_ntt(x, work, omega); }});
+        cases.push_back({"ntt/stockham_parallel/" + size + "/" + threads, copy_in, [&x, &work, omega] { stockham_parallel_ntt(x, work, omega); }});
+        cases.push_back({"ntt/radix2_serial/" + size, copy_in, [&x, omega] { radix2_serial_ntt(x, omega); }});
+        cases.push_back({"ntt/radix2_parallel/" + size + "/" + threads, copy_in, [&x, omega] { radix2_parallel_ntt(x, omega); }});
+
+        /* a * b mod x^n + 1 on every engine; the linear product of two halves on the default one */
+        for (const ntt_engine engine : engines) {
+            const std::string name = std::string("mul/") + ntt_engine_key(engine);
+            cases.push_back({name + "_serial/" + size, fill, [&a, &b, &c, engine] {
+                polynomial_multiplication_on_FFT_serial(a, b, c, convolution_kind::negacyclic, engine);
+            }});
+            cases.push_back({name + "_parallel/" + size + "/" + threads, fill, [&a, &b, &c, engine] {
+                polynomial_multiplication_on_FFT_parallel(a, b, c, convolution_kind::negacyclic, engine);
+            }});
+        }
+        auto halves = [&a, &b, &x, &work, fill, n] {
+            fill();
+            x.assign(a.begin(), a.begin() + n / 2);
+            work.assign(b.begin(), b.begin() + n / 2);
+        };
+        cases.push_back({"mul/linear_serial/" + size, halves, [&x, &work, &c] {
+            polynomial_multiplication_on_FFT_serial(x, work, c, convolution_kind::linear, ntt_engine::libfqfft);
+        }});
+        cases.push_back({"mul/linear_parallel/" + size + "/" + threads, halves, [&x, &work, &c] {
+            polynomial_multiplication_on_FFT_parallel(x, work, c, convolution_kind::linear, ntt_engine::libfqfft);
+        }});
+
+        cases.push_back({"io/write/" + size, fill, [&a] {
+            if (!write_polynomial_to_file(gate_io_file, a)) throw std::runtime_error(std::string("unable to write ") + gate_io_file);
+        }});
+        cases.push_back({"io/read/" + size, [&a, &x, fill] { fill(); x.clear(); write_polynomial_to_file(gate_io_file, a); }, [&x] {
+            if (!read_polynomial_from_file(gate_io_file, x)) throw std::runtime_error(std::string("unable to read ") + gate_io_file);
+        }});
+    }
+    return cases;
+}
+
+bool gate_selected(const std::string& name, const std::vector<std::string>& prefixes)
+{
+    if (prefixes.empty()) return true;
+    for (const auto& p : prefixes)
+        if (name.compare(0, p.size(), p) == 0) return true;
+    return false;
+}
+
+long long gate_median(std::vector<long long> v)
+{
+    std::sort(v.begin(), v.end());
+    const size_t h = v.size() / 2;
+    return v.size() % 2 ? v[h] : (v[h - 1] + v[h]) / 2;
+}
+
+/* Robust relative noise: 1.4826 * MAD / median, the standard deviation of a normal sample */
+double gate_noise(const std::vector<long long>& v)
+{
+    const long long median = gate_median(v);
+    std::vector<long long> dev(v.size());
+    for (size_t i = 0; i < v.size(); ++i) dev[i] = std::llabs(v[i] - median);
+    return 1.4826 * gate_median(dev) / std::max(median, 1ll);
+}
+
+/* One-sided Mann-Whitney p-value that `current` is slower than `base` (normal approximation) */
+double gate_p_slower(const std::vector<long long>& base, const std::vector<long long>& current)
+{
+    double u = 0;
+    for (long long c : current)
+        for (long long b : base)
+            u += c > b ? 1.0 : (c == b ? 0.5 : 0.0);
+    const double n1 = current.size();
+    const double n2 = base.size();
+    const double mean = n1 * n2 / 2;
+    const double sd = std::sqrt(n1 * n2 * (n1 + n2 + 1) / 12);
+    const double z = (u - mean - 0.5) / sd;
+    return 0.5 * std::erfc(z / std::sqrt(2.0));
+}
+
+/* Baseline file: one "config case sample_ns..." line per case */
+bool read_baseline(const std::string& filename, std::map<std::string, gate_samples>& configs)
+{
+    std::ifstream in(filename);
+    if (!in.is_open()) return false;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.empty() || line[0] == '#') continue;
+        std::istringstream fields(line);
+        std::string config, name;
+        fields >> config >> name;
+        long long ns;
+        while (fields >> ns) configs[config][name].push_back(ns);
+    }
+    return true;
+}
+
+bool write_baseline(const std::string& filename, const std::map<std::string, gate_samples>& configs)
+{
+    std::ofstream out(filename);
+    if (!out.is_open()) return false;
+    out << "# perf_gate baseline : config case sample_ns..." << std::endl;
+    for (const auto& config : configs)
+        for (const auto& c : config.second) {
+            out << config.first << " " << c.first;
+            for (long long ns : c.second) out << " " << ns;
+            out << std::endl;
+        }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    int opt;
+    std::vector<int> sizes;
+    std::vector<std::string> prefixes;
+    std::string config = "default";
+    std::string save_file;
+    std::string compare_file;
+    size_t warmup = 1;
+    size_t reps = 10;
+    double threshold = 5;
+
+    while ((opt = getopt(argc, argv, "n:k:N:s:c:w:r:T:")) != -1) {
+        switch (opt) {
+            case 'n':
+                sizes.push_back(std::stoi(optarg));
+                break;
+            case 'k':
+                prefixes.push_back(optarg);
+                break;
+            case 'N':
+                config = optarg;
+                break;
+            case 's':
+                save_file = optarg;
+                break;
+            case 'c':
+                compare_file = optarg;
+                break;
+            case 'w':
+                warmup = std::stoul(optarg);
+                break;
+            case 'r':
+                reps = std::max(5ul, std::stoul(optarg));
+                break;
+            case 'T':
+                threshold = std::stod(optarg);
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " (-s baseline | -c baseline) [-N config] [-n k]... [-k prefix]..."
+                          << " [-w warmup] [-r reps] [-T percent]" << std::endl;
+                return 1;
+        }
+    }
+    if (save_file.empty() == compare_file.empty()) {
+        std::cerr << "[-] Expected exactly one of -s (record) and -c (compare)" << std::endl;
+        return 1;
+    }
+    if (sizes.empty()) sizes = {16};
+
+    std::map<std::string, gate_samples> configs;
+    const std::string& baseline_file = save_file.empty() ? compare_file : save_file;
+    if (!read_baseline(baseline_file, configs) && !compare_file.empty()) {
+        std::cerr << "[-] Unable to open file " << compare_file << std::endl;
+        return 1;
+    }
+    if (!compare_file.empty() && configs.find(config) == configs.end()) {
+        std::cerr << "[-] No configuration " << config << " in " << compare_file << std::endl;
+        return 1;
+    }
+
+    bls12_381_pp::init_public_params();
+
+    std::vector<FieldT> a, b, x, c, work;
+    gate_samples current;
+    for (const auto& gc : gate_cases(sizes, a, b, x, c, work)) {
+        if (!gate_selected(gc.name, prefixes)) continue;
+        std::cout << "[*] processing " << gc.name;
+        std::cout.flush();
+        std::vector<long long>& samples = current[gc.name];
+        for (size_t i = 0; i < warmup + reps; ++i) {
+            gc.setup();
+            auto start_time = std::chrono::steady_clock::now();
+            gc.run();
+            auto end_time = std::chrono::steady_clock::now();
+            if (i >= warmup) samples.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(end_time - start_time).count());
+        }
+        std::cout << std::setw(_print_align + 16) << std::left << "\r[+] " + gc.name
+                  << std::setw(12) << std::right << gate_median(samples) / 1000 << " us (noise "
+                  << std::fixed << std::setprecision(1) << 100 * gate_noise(samples) << "%)" << std::defaultfloat << std::endl;
+    }
+    std::remove(gate_io_file);
+
+    if (!save_file.empty()) {
+        configs[config] = current;
+        if (!write_baseline(save_file, configs)) {
+            std::cerr << "[-] Unable to open file " << save_file << std::endl;
+            return 1;
+        }
+        std::cout << "[+] Baseline " << config << " written to " << save_file << " (" << current.size() << " cases)" << std::endl;
+        return 0;
+    }
+
+    const gate_samples& base = configs[config];
+    size_t regressions = 0;
+    std::cout << "[i] Comparison with " << config << " (threshold " << threshold << "%, p < " << gate_alpha << ")" << std::endl;
+    for (const auto& cur : current) {
+        const auto it = base.find(cur.first);
+        if (it == base.end() || it->second.empty()) {
+            std::cout << "\t - " << std::setw(_print_align) << std::left << cur.first << std::right << " no baseline" << std::endl;
+            continue;
+        }
+        const double change = static_cast<double>(gate_median(cur.second)) / std::max(gate_median(it->second), 1ll) - 1;
+        const double noise = std::sqrt(std::pow(gate_noise(cur.second), 2) + std::pow(gate_noise(it->second), 2));
+        const double limit = std::max(threshold / 100, 3 * noise);
+        const double p = gate_p_slower(it->second, cur.second);
+        const bool regressed = change > limit && p < gate_alpha;
+        const bool improved = -change > limit && gate_p_slower(cur.second, it->second) < gate_alpha;
+        if (regressed) ++regressions;
+
+        std::cout << "\t - " << std::setw(_print_align) << std::left << cur.first << std::right << std::fixed << std::setprecision(1)
+                  << std::setw(8) << 100 * change << "% (limit " << 100 * limit << "%, p " << std::setprecision(4) << p << ") "
+                  << std::defaultfloat << (regressed ? "REGRESSION" : improved ? "faster" : "ok") << std::endl;
+    }
+
+    if (regressions) {
+        std::cerr << "[-] " << regressions << " case(s) regressed against " << config << std::endl;
+        return 1;
+    }
+    std::cout << "[+] No regression against " << config << std::endl;
+    return 0;
+}
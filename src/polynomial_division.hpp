@@ -0,0 +1,135 @@
+#ifndef POLYNOMIAL_DIVISION_HPP
+#define POLYNOMIAL_DIVISION_HPP
+
+#include <libfqfft/tools/exceptions.hpp>
+
+#include "utils.hpp"
+#include "polynomial_multiplication.hpp"
+
+/* Below this divisor or quotient size schoolbook division wins; see division_test */
+const size_t newton_division_threshold = 1ul << 9;
+
+/* One product through the multiplication engine; the result is padded back to its full length */
+template <typename FieldT>
+void division_multiply(const std::vector<FieldT>& a, const std::vector<FieldT>& b, std::vector<FieldT>& c,
+                       const convolution_kind kind, const size_t size, const ntt_engine engine, const bool multicore)
+{
+    if (multicore) polynomial_multiplication_on_FFT_parallel(a, b, c, kind, engine);
+    else polynomial_multiplication_on_FFT_serial(a, b, c, kind, engine);
+    c.resize(size, FieldT::zero());
+}
+
+/* a mod (x^n - 1): fold every n-coefficient chunk onto the first */
+template <typename FieldT>
+void fold_cyclic(const std::vector<FieldT>& a, std::vector<FieldT>& c, const size_t n, const bool multicore)
+{
+    c.assign(n, FieldT::zero());
+    #pragma omp parallel for if(multicore)
+    for (size_t i = 0; i < n; ++i)
+        for (size_t j = i; j < a.size(); j += n) c[i] += a[j];
+}
+
+/*
+ * g = f^-1 mod x^k by Newton iteration, g <- g - g (f g - 1), doubling the
+ * precision l each step. Both products are size-2l cyclic convolutions: f g
+ * is known to be 1 + O(x^l), so the wrap-around only lands on the low l
+ * coefficients that are discarded, and g h with |g|, |h| <= l never wraps.
+ */
+template <typename FieldT>
+void power_series_inverse(const std::vector<FieldT>& f, const size_t k, std::vector<FieldT>& g,
+                          const ntt_engine engine, const bool multicore)
+{
+    if (f.empty() || f[0].is_zero()) throw InvalidSizeException("expected a non-zero constant term");
+
+    g.assign(1, f[0].inverse());
+    std::vector<FieldT> fl;
+    std::vector<FieldT> e;
+    std::vector<FieldT> t;
+
+    for (size_t l = 1; l < k; l *= 2) {
+        const size_t n = 2 * l;
+
+        fl.assign(f.begin(), f.begin() + std::min(n, f.size()));
+        fl.resize(n, FieldT::zero());
+        division_multiply(fl, g, e, convolution_kind::cyclic, n, engine, multicore);
+
+        /* h = (f g - 1) / x^l, padded to n so that g h stays a plain product */
+        std::fill(e.begin(), e.begin() + l, FieldT::zero());
+        std::rotate(e.begin(), e.begin() + l, e.end());
+        division_multiply(g, e, t, convolution_kind::cyclic, n, engine, multicore);
+
+        g.resize(n);
+        #pragma omp parallel for if(multicore)
+        for (size_t i = 0; i < l; ++i) g[l + i] = -t[i];
+    }
+    g.resize(k);
+}
+
+/*
+ * a = q b + r with deg r < deg b, via the reversed quotient
+ * rev(q) = rev(a) rev(b)^-1 mod x^(|a| - |b| + 1). The remainder only needs the
+ * low |b| - 1 coefficients of a - q b, so it is taken mod x^N - 1 with
+ * N = 2^ceil(log |b|) after folding a and q, whatever the size of a.
+ */
+template <typename FieldT>
+void polynomial_division_newton(std::vector<FieldT>& q, std::vector<FieldT>& r, const std::vector<FieldT>& a, const std::vector<FieldT>& b,
+                                const ntt_engine engine, const bool multicore)
+{
+    std::vector<FieldT> divisor(b);
+    _condense(divisor);
+    if (divisor.empty()) throw InvalidSizeException("expected a non-zero divisor");
+
+    std::vector<FieldT> dividend(a);
+    _condense(dividend);
+    if (dividend.size() < divisor.size()) {
+        q.clear();
+        r = dividend;
+        return;
+    }
+
+    const size_t m = dividend.size() - divisor.size() + 1;
+
+    std::vector<FieldT> rev_b(divisor.rbegin(), divisor.rend());
+    std::vector<FieldT> inv;
+    power_series_inverse(rev_b, m, inv, engine, multicore);
+
+    std::vector<FieldT> rev_a(dividend.rbegin(), dividend.rbegin() + m);
+    std::vector<FieldT> rev_q;
+    division_multiply(rev_a, inv, rev_q, convolution_kind::linear, 2 * m - 1, engine, multicore);
+    q.assign(rev_q.rend() - m, rev_q.rend());
+
+    const size_t n = libff::get_power_of_two(divisor.size());
+    std::vector<FieldT> a_n;
+    std::vector<FieldT> q_n;
+    std::vector<FieldT> qb;
+    fold_cyclic(dividend, a_n, n, multicore);
+    fold_cyclic(q, q_n, n, multicore);
+    division_multiply(q_n, divisor, qb, convolution_kind::cyclic, n, engine, multicore);
+
+    r.resize(divisor.size() - 1);
+    #pragma omp parallel for if(multicore)
+    for (size_t i = 0; i < r.size(); ++i) r[i] = a_n[i] - qb[i];
+
+    _condense(q);
+    _condense(r);
+}
+
+/* Schoolbook costs |b| * |q| multiplications, so it stays when either one is small */
+template <typename FieldT>
+void polynomial_division_on_FFT(std::vector<FieldT>& q, std::vector<FieldT>& r, const std::vector<FieldT>& a, const std::vector<FieldT>& b,
+                                const ntt_engine engine, const bool multicore)
+{
+    std::vector<FieldT> divisor(b);
+    _condense(divisor);
+    if (divisor.empty()) throw InvalidSizeException("expected a non-zero divisor");
+
+    const size_t quotient_size = a.size() >= divisor.size() ? a.size() - divisor.size() + 1 : 0;
+    if (std::min(quotient_size, divisor.size()) < newton_division_threshold) {
+        _polynomial_division(q, r, a, divisor);
+        _condense(r);
+        return;
+    }
+    polynomial_division_newton(q, r, a, divisor, engine, multicore);
+}
+
+#endif // POLYNOMIAL_DIVISION_HPP
@@ -0,0 +1,303 @@
+#ifndef POLYNOMIAL_EXPRESSION_HPP
+#define POLYNOMIAL_EXPRESSION_HPP
+
+#include <map>
+#include <memory>
+
+#include "utils.hpp"
+#include "ntt.hpp"
+#include "polynomial_multiplication.hpp"
+
+/*
+ * Lazy polynomial expressions kept in evaluation form.
+ *
+ * Building (a*b + c)*d - e only records a tree. Materializing it forward-transforms
+ * every input once (cached per context), runs all the pointwise adds, subs and muls
+ * of the tree in a single blocked pass with the 1/n scale folded into the store, and
+ * does one inverse transform. Inputs added or subtracted at the top of the tree are
+ * never transformed; they are folded into the coefficients afterwards. A node whose
+ * coefficient count would not fit the domain is computed in coefficient form
+ * instead: its operands are materialized and multiplied (or added) with the regular
+ * linear product.
+ */
+enum class expression_op { input, add, sub, mul };
+
+template <typename FieldT>
+struct expression_node
+{
+    expression_op op;
+    std::shared_ptr<const expression_node<FieldT> > lhs;
+    std::shared_ptr<const expression_node<FieldT> > rhs;
+    std::shared_ptr<const std::vector<FieldT> > coefficients;   // input only
+    size_t size;                                                  // bound on the number of coefficients
+};
+
+template <typename FieldT>
+struct polynomial_expression
+{
+    std::shared_ptr<const expression_node<FieldT> > node;
+
+    size_t size() const { return node->size; }
+};
+
+template <typename FieldT>
+polynomial_expression<FieldT> make_expression(const expression_op op, const polynomial_expression<FieldT>& a, const polynomial_expression<FieldT>& b)
+{
+    auto node = std::make_shared<expression_node<FieldT> >();
+    node->op = op;
+    node->lhs = a.node;
+    node->rhs = b.node;
+    if (op == expression_op::mul) node->size = (a.size() == 0 || b.size() == 0) ? 0 : a.size() + b.size() - 1;
+    else node->size = std::max(a.size(), b.size());
+    return polynomial_expression<FieldT>{node};
+}
+
+template <typename FieldT>
+polynomial_expression<FieldT> operator+(const polynomial_expression<FieldT>& a, const polynomial_expression<FieldT>& b)
+{
+    return make_expression(expression_op::add, a, b);
+}
+
+template <typename FieldT>
+polynomial_expression<FieldT> operator-(const polynomial_expression<FieldT>& a, const polynomial_expression<FieldT>& b)
+{
+    return make_expression(expression_op::sub, a, b);
+}
+
+template <typename FieldT>
+polynomial_expression<FieldT> operator*(const polynomial_expression<FieldT>& a, const polynomial_expression<FieldT>& b)
+{
+    return make_expression(expression_op::mul, a, b);
+}
+
+/* Work done by a context so far; passes count full-length element-wise sweeps outside the NTTs */
+struct expression_stats
+{
+    size_t forward_ntts = 0;
+    size_t inverse_ntts = 0;
+    size_t passes = 0;
+    size_t products = 0;    // coefficient-form products of nodes that overflow the domain
+};
+
+/* Elements per block of the fused pass; one block of every live register stays in L2 */
+const size_t expression_block_size = 1ul << 10;
+
+template <typename FieldT>
+class expression_context
+{
+public:
+    /* The domain is the smallest 2^k or 3 * 2^k holding max_size coefficients */
+    expression_context(const size_t max_size, const ntt_engine engine, const bool multicore)
+        : params(convolution_kind::linear, get_smooth_size(std::max<size_t>(max_size, 1))), engine(engine), multicore(multicore) {}
+
+    polynomial_expression<FieldT> input(const std::vector<FieldT>& a)
+    {
+        auto node = std::make_shared<expression_node<FieldT> >();
+        node->op = expression_op::input;
+        node->coefficients = std::make_shared<const std::vector<FieldT> >(a);
+        node->size = a.size();
+        return polynomial_expression<FieldT>{node};
+    }
+
+    void materialize(const polynomial_expression<FieldT>& e, std::vector<FieldT>& c)
+    {
+        materialize(e.node.get(), c);
+        _condense(c);
+    }
+
+    size_t domain_size() const { return params.n; }
+    const expression_stats& stats() const { return counters; }
+
+private:
+    struct instruction
+    {
+        expression_op op;
+        size_t lhs;
+        size_t rhs;
+        const FieldT* src;
+    };
+
+    struct cached_evaluation
+    {
+        std::shared_ptr<const expression_node<FieldT> > node;   // keeps the key alive
+        std::vector<FieldT> evaluations;
+    };
+
+    convolution_params<FieldT> params;
+    const ntt_engine engine;
+    const bool multicore;
+    expression_stats counters;
+    std::map<const expression_node<FieldT>*, cached_evaluation> cache;
+
+    /* Forward transform of an input, done once per input and context */
+    const std::vector<FieldT>& evaluations(const std::shared_ptr<const expression_node<FieldT> >& leaf)
+    {
+        auto it = cache.find(leaf.get());
+        if (it != cache.end()) return it->second.evaluations;
+
+        cached_evaluation& entry = cache[leaf.get()];
+        entry.node = leaf;
+        std::vector<FieldT> work;
+
+        /* 3 * 2^k domains keep the evaluations in radix-3 block order; pointwise work does not care */
+        if (params.n % 3 == 0) {
+            const size_t m = params.n / 3;
+            const FieldT omega_m = params.omega^3;
+            std::vector<FieldT> y[3];
+            radix3_split(y, *leaf->coefficients, params.n, params.omega, ntt_twist<FieldT>(), multicore);
+            entry.evaluations.resize(params.n);
+            for (size_t r = 0; r < 3; ++r) {
+                engine_ntt(y[r], work, omega_m, engine, multicore);
+                std::copy(y[r].begin(), y[r].end(), entry.evaluations.begin() + r * m);
+            }
+        } else {
+            if (multicore) twisted_copy_parallel(entry.evaluations, *leaf->coefficients, params.n, ntt_twist<FieldT>());
+            else twisted_copy_serial(entry.evaluations, *leaf->coefficients, params.n, ntt_twist<FieldT>());
+            engine_ntt(entry.evaluations, work, params.omega, engine, multicore);
+        }
+        counters.forward_ntts++;
+        counters.passes++;
+        return entry.evaluations;
+    }
+
+    /* x +- input where the input has no evaluations yet: adding it after the inverse transform saves a forward NTT */
+    bool foldable(const expression_node<FieldT>* node) const
+    {
+        if (node->op == expression_op::mul || node->op == expression_op::input) return false;
+        const bool lhs_input = node->lhs->op == expression_op::input;
+        const bool rhs_input = node->rhs->op == expression_op::input;
+        if (lhs_input == rhs_input) return false;
+        return cache.find((lhs_input ? node->lhs : node->rhs).get()) == cache.end();
+    }
+
+    /* Lower the subtree into straight-line code; shared subexpressions get one register */
+    size_t compile(const std::shared_ptr<const expression_node<FieldT> >& node, std::vector<instruction>& program,
+                   std::map<const expression_node<FieldT>*, size_t>& registers)
+    {
+        auto it = registers.find(node.get());
+        if (it != registers.end()) return it->second;
+
+        instruction ins = {node->op, 0, 0, nullptr};
+        if (node->op == expression_op::input) {
+            ins.src = evaluations(node).data();
+        } else {
+            ins.lhs = compile(node->lhs, program, registers);
+            ins.rhs = compile(node->rhs, program, registers);
+        }
+        program.push_back(ins);
+        return registers[node.get()] = program.size() - 1;
+    }
+
+    void materialize(const expression_node<FieldT>* node, std::vector<FieldT>& c)
+    {
+        if (node->op == expression_op::input) {
+            c = *node->coefficients;
+            return;
+        }
+        if (node->size > params.n || foldable(node)) {
+            materialize_coefficients(node, c);
+            return;
+        }
+
+        std::vector<instruction> program;
+        std::map<const expression_node<FieldT>*, size_t> registers;
+        compile(node->lhs, program, registers);
+        compile(node->rhs, program, registers);
+        const size_t lhs = registers[node->lhs.get()];
+        const size_t rhs = registers[node->rhs.get()];
+        program.push_back(instruction{node->op, lhs, rhs, nullptr});
+
+        const size_t n = params.n;
+        const size_t block = std::min(n, expression_block_size);
+        const size_t blocks = (n + block - 1) / block;
+        const FieldT scale = params.post.scale;
+        c.resize(n);
+
+        /* One pass: every register of a block is computed before the next block is touched */
+        #pragma omp parallel if(multicore)
+        {
+            std::vector<std::vector<FieldT> > scratch(program.size());
+            std::vector<const FieldT*> reg(program.size());
+            for (size_t r = 0; r < program.size(); ++r)
+                if (program[r].op != expression_op::input) scratch[r].resize(block);
+
+            #pragma omp for
+            for (size_t k = 0; k < blocks; ++k) {
+                const size_t begin = k * block;
+                const size_t len = std::min(block, n - begin);
+                for (size_t r = 0; r < program.size(); ++r) {
+                    const instruction& ins = program[r];
+                    if (ins.op == expression_op::input) {
+                        reg[r] = ins.src + begin;
+                        continue;
+                    }
+                    FieldT* dst = scratch[r].data();
+                    const FieldT* x = reg[ins.lhs];
+                    const FieldT* y = reg[ins.rhs];
+                    switch (ins.op) {
+                        case expression_op::add:
+                            for (size_t i = 0; i < len; ++i) dst[i] = x[i] + y[i];
+                            break;
+                        case expression_op::sub:
+                            for (size_t i = 0; i < len; ++i) dst[i] = x[i] - y[i];
+                            break;
+                        default:
+                            if (ins.lhs == ins.rhs) for (size_t i = 0; i < len; ++i) dst[i] = x[i].squared();
+                            else for (size_t i = 0; i < len; ++i) dst[i] = x[i] * y[i];
+                            break;
+                    }
+                    reg[r] = dst;
+                }
+                const FieldT* result = reg.back();
+                for (size_t i = 0; i < len; ++i) c[begin + i] = result[i] * scale;
+            }
+        }
+        counters.passes++;
+        ntt_count_pass();
+
+        std::vector<FieldT> work;
+        if (n % 3 == 0) {
+            const size_t m = n / 3;
+            const FieldT omega_m_inv = params.omega_inv^3;
+            std::vector<FieldT> y[3];
+            for (size_t r = 0; r < 3; ++r) {
+                y[r].assign(c.begin() + r * m, c.begin() + (r + 1) * m);
+                engine_ntt(y[r], work, omega_m_inv, engine, multicore);
+            }
+            radix3_merge(c, y, params.omega_inv, ntt_twist<FieldT>(), multicore);
+        } else {
+            engine_ntt(c, work, params.omega_inv, engine, multicore);
+        }
+        counters.inverse_ntts++;
+        c.resize(node->size);
+    }
+
+    /* A node too large for the domain, or one adding an untransformed input: combine the operands in coefficient form */
+    void materialize_coefficients(const expression_node<FieldT>* node, std::vector<FieldT>& c)
+    {
+        std::vector<FieldT> x;
+        std::vector<FieldT> y;
+        const bool square = node->op == expression_op::mul && node->lhs == node->rhs;
+        materialize(node->lhs.get(), x);
+        if (!square) materialize(node->rhs.get(), y);
+
+        if (node->op == expression_op::mul) {
+            if (multicore) polynomial_multiplication_on_FFT_parallel(x, square ? x : y, c, convolution_kind::linear, engine);
+            else polynomial_multiplication_on_FFT_serial(x, square ? x : y, c, convolution_kind::linear, engine);
+            counters.products++;
+            return;
+        }
+
+        c.assign(node->size, FieldT::zero());
+        #pragma omp parallel for if(multicore)
+        for (size_t i = 0; i < c.size(); ++i) {
+            const FieldT xi = i < x.size() ? x[i] : FieldT::zero();
+            const FieldT yi = i < y.size() ? y[i] : FieldT::zero();
+            c[i] = node->op == expression_op::add ? xi + yi : xi - yi;
+        }
+        counters.passes++;
+        ntt_count_pass();
+    }
+};
+
+#endif // POLYNOMIAL_EXPRESSION_HPP
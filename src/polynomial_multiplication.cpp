@@ -1,55 +1,23 @@
-#include "utils.hpp"
-
-/* Polynomial Multiplication via FFT with output parameter */
-template <typename FieldT>
-void polynomial_multiplication_on_FFT_serial(const std::vector<FieldT>& a, const std::vector<FieldT>& b, std::vector<FieldT>& c)
-{
-    // // -- # Cycle Convolution --
-    // const size_t n = libff::get_power_of_two(a.size() + b.size() - 1);
-    // FieldT omega = libff::get_root_of_unity<FieldT>(n);
-
-    // std::vector<FieldT> u(a);
-    // std::vector<FieldT> v(b);
-
-    // u.resize(n, FieldT::zero());
-    // v.resize(n, FieldT::zero());
-    // c.resize(n, FieldT::zero());    
-    // // ---------------------------
-
-    // -- # Negative Wrapped Convolution --
-    const size_t n = libff::get_power_of_two(a.size());
-    FieldT omega = libff::get_root_of_unity<FieldT>(2*n);
-
-    std::vector<FieldT> u(a);
-    std::vector<FieldT> v(b);
-
-    u.resize(n, FieldT::zero());
-    v.resize(n, FieldT::zero());
-    c.resize(n, FieldT::zero());
-    // -------------------------------------
-
-    _basic_serial_radix2_FFT(u, omega);
-    _basic_serial_radix2_FFT(v, omega);    
-
-    std::transform(u.begin(), u.end(), v.begin(), c.begin(), std::multiplies<FieldT>());
-    
-    _basic_serial_radix2_FFT(c, omega.inverse());  
-
-    const FieldT sconst = FieldT(n).inverse();
-    std::transform(c.begin(), c.end(), c.begin(), std::bind(std::multiplies<FieldT>(), sconst, std::placeholders::_1));
-    _condense(c);
+#include <array>
+#include <sstream>
 
-    return;
-}
+#include "utils.hpp"
+#include "polynomial_multiplication.hpp"
 
 template <typename FieldT>
-void polynomial_multiplication_serial(const std::vector<FieldT>& a, const std::vector<FieldT>& b, std::vector<FieldT>& c)
+void polynomial_multiplication_serial(const std::vector<FieldT>& a, const std::vector<FieldT>& b, std::vector<FieldT>& c, const convolution_kind kind, const ntt_engine engine,
+                                 const size_t block = 0)
 {
     std::cout << "[*] processing Serial FFT";
     std::cout.flush();
     
     auto start_time = std::chrono::high_resolution_clock::now();
-    polynomial_multiplication_on_FFT_serial<FieldT>(a, b, c);
+    if (block) {
+        polynomial_multiplication_overlap_add(a, b, c, block, engine, false);
+        _condense(c);
+    } else {
+        polynomial_multiplication_on_FFT_serial<FieldT>(a, b, c, kind, engine);
+    }
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
     auto minutes = duration.count() / 60000;
@@ -63,56 +31,41 @@ void polynomial_multiplication_serial(const std::vector<FieldT>& a, const std::v
     return;
 }
 
-/* Polynomial Multiplication via FFT with output parameter */
 template <typename FieldT>
-void polynomial_multiplication_on_FFT_parallel(const std::vector<FieldT>& a, const std::vector<FieldT>& b, std::vector<FieldT>& c)
+void polynomial_multiplication_parallel(const std::vector<FieldT>& a, const std::vector<FieldT>& b, std::vector<FieldT>& c, const convolution_kind kind, const ntt_engine engine,
+                                   const size_t block = 0)
 {
-    // // -- # Cycle Convolution --
-    // const size_t n = libff::get_power_of_two(a.size() + b.size() - 1);
-    // FieldT omega = libff::get_root_of_unity<FieldT>(n);
-
-    // std::vector<FieldT> u(a);
-    // std::vector<FieldT> v(b);
-
-    // u.resize(n, FieldT::zero());
-    // v.resize(n, FieldT::zero());
-    // c.resize(n, FieldT::zero());    
-    // // ---------------------------
-
-    // -- # Negative Wrapped Convolution --
-    const size_t n = libff::get_power_of_two(a.size());
-    FieldT omega = libff::get_root_of_unity<FieldT>(n);
-
-    std::vector<FieldT> u(a);
-    std::vector<FieldT> v(b);
-
-    u.resize(n, FieldT::zero());
-    v.resize(n, FieldT::zero());
-    c.resize(n, FieldT::zero());
-    // -------------------------------------
- 
-    _basic_parallel_radix2_FFT(u, omega);
-    _basic_parallel_radix2_FFT(v, omega);
-
-    std::transform(u.begin(), u.end(), v.begin(), c.begin(), std::multiplies<FieldT>());
-     
-    _basic_parallel_radix2_FFT(c, omega.inverse());
+    std::cout << "[*] processing Parallel FFT";
+    std::cout.flush();
+    
+    auto start_time = std::chrono::high_resolution_clock::now();
+    if (block) {
+        polynomial_multiplication_overlap_add(a, b, c, block, engine, true);
+        _condense(c);
+    } else {
+        polynomial_multiplication_on_FFT_parallel<FieldT>(a, b, c, kind, engine);
+    }
+    auto end_time = std::chrono::high_resolution_clock::now();
+    auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+    auto minutes = duration.count() / 60000;
+    auto seconds = (duration.count() % 60000) / 1000;
+    auto milliseconds = duration.count() % 1000;
 
-    const FieldT sconst = FieldT(n).inverse();
-    std::transform(c.begin(), c.end(), c.begin(), std::bind(std::multiplies<FieldT>(), sconst, std::placeholders::_1));
-    _condense(c);
+    std::cout << std::dec;
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Parallel FFT process complete"
+              << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
 
     return;
 }
 
 template <typename FieldT>
-void polynomial_multiplication_parallel(const std::vector<FieldT>& a, const std::vector<FieldT>& b, std::vector<FieldT>& c)
+void polynomial_multiplication_prepared(const std::vector<FieldT>& a, const prepared_operand<FieldT>& prep, std::vector<FieldT>& c, const bool multicore, const ntt_engine engine)
 {
-    std::cout << "[*] processing Parallel FFT";
+    std::cout << "[*] processing Prepared FFT";
     std::cout.flush();
     
     auto start_time = std::chrono::high_resolution_clock::now();
-    polynomial_multiplication_on_FFT_parallel<FieldT>(a, b, c);
+    polynomial_multiplication_on_prepared<FieldT>(a, prep, c, engine, multicore);
     auto end_time = std::chrono::high_resolution_clock::now();
     auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
     auto minutes = duration.count() / 60000;
@@ -120,22 +73,216 @@ void polynomial_multiplication_parallel(const std::vector<FieldT>& a, const std:
     auto milliseconds = duration.count() % 1000;
 
     std::cout << std::dec;
-    std::cout << std::setw(_print_align) << std::left << "\r[+] Parallel FFT process complete"
+    std::cout << std::setw(_print_align) << std::left << "\r[+] Prepared FFT process complete"
               << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
 
     return;
 }
 
-void parse_arguments(int argc, char *argv[], bool &multicore, bool &test_mode, bool &debug_mode) {
+/*
+ * Pre-flight check of the multiplication's peak memory against MemAvailable.
+ * When the estimate does not fit, fall back to the radix-2 engine (no libfqfft
+ * scratch buffer), then for a linear product to the largest overlap-add block
+ * that fits. Returns false when nothing fits, unless force is set.
+ */
+bool plan_memory(const convolution_kind kind, const size_t a_size, const size_t b_size, const bool square, ntt_engine& engine,
+                 const bool multicore, size_t& block, const bool force)
+{
+    const double MB = 1024.0 * 1024.0;
+    const size_t available = get_available_memory_kb() * 1024;
+    size_t estimate = polynomial_multiplication_memory<FieldT>(kind, a_size, b_size, engine, multicore, square);
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "[i] Memory Estimate : " << estimate / MB << " MB (available " << available / MB << " MB)" << std::endl;
+    std::cout << std::defaultfloat;
+    if (estimate <= available) return true;
+
+    if (engine == ntt_engine::libfqfft && multicore &&
+        polynomial_multiplication_memory<FieldT>(kind, a_size, b_size, ntt_engine::radix2, multicore, square) <= available) {
+        engine = ntt_engine::radix2;
+        std::cout << "[!] Not enough memory for the libfqfft parallel FFT scratch : using the radix2 engine" << std::endl;
+        return true;
+    }
+
+    if (kind == convolution_kind::linear) {
+        const size_t long_size = std::max(a_size, b_size);
+        const size_t short_size = std::min(a_size, b_size);
+        for (size_t n = libff::get_power_of_two(long_size + short_size - 1) / 2; n >= libff::get_power_of_two(2 * short_size - 1); n /= 2) {
+            estimate = polynomial_multiplication_memory<FieldT>(kind, a_size, b_size, engine, multicore, square, n);
+            if (estimate > available) continue;
+            block = n;
+            std::cout << std::fixed << std::setprecision(1);
+            std::cout << "[!] Not enough memory for one transform : overlap-add with blocks of " << n
+                      << " (" << estimate / MB << " MB)" << std::endl;
+            std::cout << std::defaultfloat;
+            return true;
+        }
+    }
+
+    if (force) {
+        std::cout << "[!] Estimated memory exceeds available memory : continuing (--force)" << std::endl;
+        return true;
+    }
+    std::cerr << "[-] Estimated memory exceeds available memory and no lower-memory strategy fits (use -F to run anyway)" << std::endl;
+    return false;
+}
+
+/* Pre-flight check for the paths without a lower-memory fallback: refuses an estimate above MemAvailable unless force is set */
+bool check_memory(const size_t estimate, const bool force)
+{
+    const double MB = 1024.0 * 1024.0;
+    const size_t available = get_available_memory_kb() * 1024;
+
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "[i] Memory Estimate : " << estimate / MB << " MB (available " << available / MB << " MB)" << std::endl;
+    std::cout << std::defaultfloat;
+    if (estimate <= available) return true;
+
+    if (force) {
+        std::cout << "[!] Estimated memory exceeds available memory : continuing (--force)" << std::endl;
+        return true;
+    }
+    std::cerr << "[-] Estimated memory exceeds available memory (use -F to run anyway)" << std::endl;
+    return false;
+}
+
+/* Batch manifest: one "input_a input_b output_c" triple per line, '#' starts a comment */
+bool read_manifest(const std::string& filename, std::vector<std::array<std::string, 3> >& pairs)
+{
+    std::ifstream manifest(filename);
+    if (!manifest.is_open()) {
+        std::cerr << "[-] Unable to open " << filename << std::endl;
+        return false;
+    }
+
+    std::string line;
+    size_t line_no = 0;
+    while (std::getline(manifest, line)) {
+        ++line_no;
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::array<std::string, 3> pair;
+        if (!(fields >> pair[0])) continue;
+        std::string extra;
+        if (!(fields >> pair[1] >> pair[2]) || (fields >> extra)) {
+            std::cerr << "[-] " << filename << ":" << line_no << " : expected input_a input_b output_c" << std::endl;
+            return false;
+        }
+        pairs.push_back(pair);
+    }
+    return true;
+}
+
+/*
+ * Batch mode: multiply every pair of the manifest, a window of pairs at a time, and report throughput.
+ * A window holds at most max(16, 4 * threads) pairs and, by the pairs' estimated peak memory summed,
+ * no more than MemAvailable; a pair that does not fit on its own stops the batch unless force is set.
+ */
+int run_batch(const std::string& filename, const convolution_kind kind, const ntt_engine engine, const bool multicore, const bool force)
+{
+    std::vector<std::array<std::string, 3> > pairs;
+    if (!read_manifest(filename, pairs)) return 1;
+
+    std::cout << "[i] Batch : " << pairs.size() << " pairs from " << filename << std::endl;
+
+    std::vector<size_t> estimates(pairs.size());
+    size_t largest = 0;
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        const size_t a_size = polynomial_file_size(pairs[i][0]);
+        const size_t b_size = polynomial_file_size(pairs[i][1]);
+        estimates[i] = (a_size && b_size) ? polynomial_multiplication_memory<FieldT>(kind, a_size, b_size, engine, multicore, false) : 0;
+        if (estimates[i] > estimates[largest]) largest = i;
+    }
+    if (!pairs.empty()) {
+        std::cout << "[i] Largest pair : " << largest << " (" << pairs[largest][0] << ", " << pairs[largest][1] << ")" << std::endl;
+        if (!check_memory(estimates[largest], force)) return 1;
+    }
+
+    /* Measured once: memory freed by one window stays with the allocator, so MemAvailable would not recover */
+    const size_t available = get_available_memory_kb() * 1024;
+    const size_t max_window = std::max<size_t>(16, 4 * omp_get_max_threads());
+    bool limited = false;
+    double compute_seconds = 0;
+    auto total_start = std::chrono::high_resolution_clock::now();
+
+    for (size_t begin = 0, end = 0; begin < pairs.size(); begin = end) {
+        size_t window_bytes = 0;
+        while (end < pairs.size() && end - begin < max_window && (end == begin || window_bytes + estimates[end] <= available))
+            window_bytes += estimates[end++];
+        if (!limited && end < pairs.size() && end - begin < max_window) {
+            std::cout << "[!] Batch window limited by the available memory : " << end - begin << " of " << max_window << " pairs" << std::endl;
+            limited = true;
+        }
+        std::vector<std::vector<FieldT> > as(end - begin);
+        std::vector<std::vector<FieldT> > bs(end - begin);
+        std::vector<std::vector<FieldT> > cs;
+
+        for (size_t i = begin; i < end; ++i) {
+            if (!read_polynomial_from_file(pairs[i][0], as[i - begin]) || !read_polynomial_from_file(pairs[i][1], bs[i - begin])) {
+                std::cerr << "[-] Unable to read pair " << i << " (" << pairs[i][0] << ", " << pairs[i][1] << ")" << std::endl;
+                return 1;
+            }
+        }
+        memory_checkpoint("batch read");
+
+        std::cout << "[*] processing Batch FFT " << end << "/" << pairs.size();
+        std::cout.flush();
+        auto start_time = std::chrono::high_resolution_clock::now();
+        polynomial_multiplication_batch(as, bs, cs, kind, engine, multicore);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        compute_seconds += std::chrono::duration<double>(end_time - start_time).count();
+        memory_checkpoint("batch compute");
+        std::cout << "\r";
+
+        for (size_t i = begin; i < end; ++i) {
+            if (!write_polynomial_to_file(pairs[i][2], cs[i - begin])) {
+                std::cerr << "[-] Unable to write to " << pairs[i][2] << std::endl;
+                return 1;
+            }
+        }
+        memory_checkpoint("batch write");
+    }
+
+    auto total_end = std::chrono::high_resolution_clock::now();
+    const double total_seconds = std::chrono::duration<double>(total_end - total_start).count();
+
+    std::cout << std::string(_print_align + 20, ' ') << "\r[+] Batch FFT process complete" << std::endl;
+    std::cout << "[i] Batch Throughput" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+    std::cout << "\t - Multiplications : " << pairs.size() << std::endl;
+    std::cout << "\t - Compute Time : " << compute_seconds << " s (" << (compute_seconds > 0 ? pairs.size() / compute_seconds : 0) << " mul/s)" << std::endl;
+    std::cout << "\t - Total Time (with I/O) : " << total_seconds << " s (" << (total_seconds > 0 ? pairs.size() / total_seconds : 0) << " mul/s)" << std::endl;
+    std::cout << std::defaultfloat;
+
+    return 0;
+}
+
+void parse_arguments(int argc, char *argv[], bool &multicore, bool &test_mode, bool &debug_mode, ntt_engine &engine, convolution_kind &kind,
+                     std::string &prepared_in, std::string &prepared_out, std::string &batch, bool &memory_report, bool &force) {
     multicore = false;
     test_mode = false;
     debug_mode = false;
-
-    const char *short_opts = "mtd";
+    memory_report = false;
+    force = false;
+    engine = ntt_engine::libfqfft;
+    kind = convolution_kind::negacyclic;
+    prepared_in.clear();
+    prepared_out.clear();
+    batch.clear();
+
+    const char *short_opts = "mtdse:k:p:P:b:MF";
     const option long_opts[] = {
         {"multicore", no_argument, nullptr, 'm'},
         {"test", no_argument, nullptr, 't'},
         {"debug", no_argument, nullptr, 'd'},
+        {"stockham", no_argument, nullptr, 's'},
+        {"engine", required_argument, nullptr, 'e'},
+        {"kind", required_argument, nullptr, 'k'},
+        {"prepared", required_argument, nullptr, 'p'},
+        {"save-prepared", required_argument, nullptr, 'P'},
+        {"batch", required_argument, nullptr, 'b'},
+        {"memory", no_argument, nullptr, 'M'},
+        {"force", no_argument, nullptr, 'F'},
         {nullptr, no_argument, nullptr, 0}
     };
 
@@ -151,8 +298,35 @@ void parse_arguments(int argc, char *argv[], bool &multicore, bool &test_mode, b
             case 'd':
                 debug_mode = true;
                 break;
+            case 's':
+                engine = ntt_engine::stockham;
+                break;
+            case 'e':
+                if (parse_ntt_engine(optarg, engine)) break;
+                std::cerr << "[-] Unknown engine " << optarg << " (libfqfft|stockham|radix2)" << std::endl;
+                exit(EXIT_FAILURE);
+            case 'k':
+                if (parse_convolution_kind(optarg, kind)) break;
+                std::cerr << "[-] Unknown convolution kind " << optarg << " (cyclic|negacyclic|linear)" << std::endl;
+                exit(EXIT_FAILURE);
+            case 'p':
+                prepared_in = optarg;
+                break;
+            case 'P':
+                prepared_out = optarg;
+                break;
+            case 'b':
+                batch = optarg;
+                break;
+            case 'M':
+                memory_report = true;
+                break;
+            case 'F':
+                force = true;
+                break;
             default:
-                std::cerr << "Usage: " << argv[0] << " [-m|--multicore] [-t|--test] [-d|--debug]" << std::endl;
+                std::cerr << "Usage: " << argv[0] << " [-m|--multicore] [-t|--test] [-d|--debug] [-s|--stockham] [-e|--engine libfqfft|stockham|radix2] [-k|--kind cyclic|negacyclic|linear]"
+                          << " [-p|--prepared file] [-P|--save-prepared file] [-b|--batch manifest] [-M|--memory] [-F|--force]" << std::endl;
                 exit(EXIT_FAILURE);
         }
     }
@@ -162,8 +336,16 @@ int main(int argc, char *argv[]) {
     bool multicore;
     bool test_mode;
     bool debug_mode;
+    ntt_engine engine;
+    convolution_kind kind;
+    std::string prepared_in;
+    std::string prepared_out;
+    std::string batch;
+    bool memory_report;
+    bool force;
 
-    parse_arguments(argc, argv, multicore, test_mode, debug_mode);
+    parse_arguments(argc, argv, multicore, test_mode, debug_mode, engine, kind, prepared_in, prepared_out, batch, memory_report, force);
+    if (memory_report) enable_memory_report();
 
     if (multicore) {
         const size_t num_cpus = omp_get_max_threads();
@@ -174,6 +356,8 @@ int main(int argc, char *argv[]) {
     } else {
         std::cout << "[i] Mode : Serial" << std::endl;
     }
+    std::cout << "\t- engine : " << ntt_engine_name(engine) << std::endl;
+    std::cout << "\t- convolution : " << convolution_kind_name(kind) << std::endl;
 
     std::vector<FieldT> a;
     std::vector<FieldT> b;
@@ -181,33 +365,89 @@ int main(int argc, char *argv[]) {
 
     bls12_381_pp::init_public_params();
 
+    if (!batch.empty()) {
+        const int status = run_batch(batch, kind, engine, multicore, force);
+        NTT_PROFILE_REPORT(std::cout);
+        print_memory_report();
+        return status;
+    }
+
+    /* Fixed multiplier: b comes from a prepared file and is never transformed here */
+    prepared_operand<FieldT> prep;
+    const bool use_prepared = !prepared_in.empty() || !prepared_out.empty();
+    if (!prepared_in.empty()) {
+        if(!read_prepared_operand(prepared_in, prep)) return 1;
+        kind = prep.kind;
+    }
+
+    /* Squaring: when input_b repeats input_a, only one operand is read and transformed */
+    bool square = false;
+    size_t block = 0;
     if (!test_mode) { 
+        square = prepared_in.empty() && same_polynomial_file("data/input_a.txt", "data/input_b.txt");
+        const size_t a_size = polynomial_file_size("data/input_a.txt");
+        const size_t b_size = !prepared_in.empty() ? prep.b_size : square ? a_size : polynomial_file_size("data/input_b.txt");
+        if (!use_prepared) {
+            if (a_size && b_size && !plan_memory(kind, a_size, b_size, square, engine, multicore, block, force)) return 1;
+        } else if (a_size && b_size) {
+            /* -p keeps only the evaluations of b; -P holds b while preparing it at the size a needs */
+            const size_t n = !prepared_in.empty() ? prep.params.n : convolution_size(kind, a_size, b_size);
+            const bool b_held = prepared_in.empty() && !square;
+            if (!check_memory(prepared_multiplication_memory<FieldT>(kind, a_size, b_size, n, b_held, engine, multicore), force)) return 1;
+        }
         if(!read_polynomial("data/input_a.txt", a)) return 1;
-        if(!read_polynomial("data/input_b.txt", b)) return 1;
+        memory_checkpoint("read a");
+        if(!square && prepared_in.empty() && !read_polynomial("data/input_b.txt", b)) return 1;
+        if(!square && prepared_in.empty()) memory_checkpoint("read b");
+        if(square) std::cout << "[i] input_b matches input_a : squaring" << std::endl;
     } else {
         a = {1, 2};
         b = {3, 5};
     }
 
-    const size_t n = libff::get_power_of_two(a.size());
-    FieldT omega = libff::get_root_of_unity<FieldT>(n);
+    const std::vector<FieldT>& b_in = square ? a : b;
+
+    /* Cyclic and negacyclic products wrap at the prepared transform size, so a longer a cannot be split */
+    if (!prepared_in.empty() && prep.kind != convolution_kind::linear && a.size() > prepared_max_a_size(prep)) {
+        std::cerr << "[-] input_a has " << a.size() << " coefficients, more than the " << prepared_max_a_size(prep)
+                  << " of the " << convolution_kind_name(prep.kind) << " prepared operand " << prepared_in << std::endl;
+        return 1;
+    }
+
+    if (!prepared_out.empty()) {
+        prepare_operand(b_in, kind, a.size(), prep, engine, multicore);
+        if(!write_prepared_operand(prepared_out, prep)) return 1;
+    }
+
+    const convolution_params<FieldT> params = prepared_in.empty() ? convolution_params<FieldT>(kind, convolution_size(kind, a.size(), b_in.size())) : prep.params;
     std::cout << "[i] NTT Parameter" << std::endl;
-    std::cout << "\t - Polynomial Size : " << n << std::endl;
-    std::cout << "\t - Omega : 0x" << std::hex << omega << std::endl;
-    std::cout << "\t - O_inv : 0x" << std::hex << omega.inverse() << std::endl;
+    std::cout << "\t - Polynomial Size : " << params.n << std::endl;
+    std::cout << "\t - Omega : 0x" << std::hex << params.omega << std::endl;
+    std::cout << "\t - O_inv : 0x" << std::hex << params.omega_inv << std::endl;
+    if (!prepared_in.empty()) {
+        std::cout << "\t - Prepared Operand : " << prepared_in << " (" << convolution_kind_name(prep.kind) << ", |b| = " << std::dec << prep.b_size << ")" << std::endl;
+    } else if (kind == convolution_kind::linear && !use_prepared) {
+        const size_t shown = block ? block : overlap_add_block_size(std::max(a.size(), b_in.size()), std::min(a.size(), b_in.size()));
+        if (shown) std::cout << "\t - Overlap-add Block : " << std::dec << shown << std::endl;
+    }
 
-    if(multicore) polynomial_multiplication_parallel(a, b, c);
-    else polynomial_multiplication_serial(a, b, c);
+    if(use_prepared) polynomial_multiplication_prepared(a, prep, c, multicore, engine);
+    else if(multicore) polynomial_multiplication_parallel(a, b_in, c, kind, engine, block);
+    else polynomial_multiplication_serial(a, b_in, c, kind, engine, block);
     
     if (!test_mode) { 
         if(!write_polynomial("data/output_c.txt", c)) return 1;
+        memory_checkpoint("write c");
     }
 
     if (test_mode || debug_mode) {
         print_polynomial(a);
-        print_polynomial(b);
+        if (prepared_in.empty()) print_polynomial(b_in);
         print_polynomial(c);
     }
+
+    NTT_PROFILE_REPORT(std::cout);
+    print_memory_report();
     
     return 0;
 }
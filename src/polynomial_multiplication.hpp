@@ -0,0 +1,702 @@
+#ifndef POLYNOMIAL_MULTIPLICATION_HPP
+#define POLYNOMIAL_MULTIPLICATION_HPP
+
+#include "utils.hpp"
+#include "ntt.hpp"
+
+/*
+ * What the product is reduced by.
+ *  - cyclic     : a * b mod x^n - 1
+ *  - negacyclic : a * b mod x^n + 1 (inputs twisted by powers of a 2n-th root psi)
+ *  - linear     : the full product, n >= |a| + |b| - 1
+ * For cyclic and negacyclic, n is the power of two covering the longer operand.
+ * For linear, n is 2^k or 3 * 2^k (see convolution_size).
+ */
+enum class convolution_kind { cyclic, negacyclic, linear };
+
+inline const char* convolution_kind_name(const convolution_kind kind)
+{
+    switch (kind) {
+        case convolution_kind::cyclic:     return "cyclic (mod x^n - 1)";
+        case convolution_kind::negacyclic: return "negacyclic (mod x^n + 1)";
+        case convolution_kind::linear:     return "linear";
+    }
+    return "unknown";
+}
+
+inline bool parse_convolution_kind(const std::string& name, convolution_kind& kind)
+{
+    if (name == "cyclic") kind = convolution_kind::cyclic;
+    else if (name == "negacyclic") kind = convolution_kind::negacyclic;
+    else if (name == "linear") kind = convolution_kind::linear;
+    else return false;
+    return true;
+}
+
+/*
+ * Transform size used to multiply polynomials with a_size and b_size coefficients.
+ * A linear product only needs n >= |a| + |b| - 1, so it may use a 3 * 2^k size
+ * instead of doubling to the next power of two.
+ */
+inline size_t convolution_size(const convolution_kind kind, const size_t a_size, const size_t b_size)
+{
+    if (kind == convolution_kind::linear) return get_smooth_size(a_size + b_size - 1);
+    return libff::get_power_of_two(std::max(a_size, b_size));
+}
+
+/*
+ * Transform parameters for one convolution of size n.
+ * The negacyclic psi-twist goes into `pre` (forward) and `post` (inverse, together with 1/n),
+ * so no engine spends a separate pass over memory on it.
+ */
+template <typename FieldT>
+struct convolution_params
+{
+    size_t n;
+    FieldT omega;
+    FieldT omega_inv;
+    ntt_twist<FieldT> pre;
+    ntt_twist<FieldT> post;
+
+    convolution_params() : n(0) {}
+    convolution_params(const convolution_kind kind, const size_t n) : n(n)
+    {
+        if (kind == convolution_kind::negacyclic) {
+            const FieldT psi = get_smooth_root_of_unity<FieldT>(2*n);
+            omega = psi.squared();
+            pre = ntt_twist<FieldT>(FieldT::one(), psi);
+            post = ntt_twist<FieldT>(FieldT(n).inverse(), psi.inverse());
+        } else {
+            omega = get_smooth_root_of_unity<FieldT>(n);
+            post = ntt_twist<FieldT>(FieldT(n).inverse(), FieldT::one());
+        }
+        omega_inv = omega.inverse();
+    }
+};
+
+/* c = u * v pointwise; passing the same vector twice squares it instead */
+template <typename FieldT>
+void pointwise_product(const std::vector<FieldT>& u, const std::vector<FieldT>& v, std::vector<FieldT>& c)
+{
+    c.resize(u.size());
+    ntt_count_pass();
+    if (&u == &v) std::transform(u.begin(), u.end(), c.begin(), [](const FieldT& x) { return x.squared(); });
+    else std::transform(u.begin(), u.end(), v.begin(), c.begin(), std::multiplies<FieldT>());
+}
+
+/* One forward or inverse power-of-two transform through the selected engine */
+template <typename FieldT>
+void engine_ntt(std::vector<FieldT>& a, std::vector<FieldT>& work, const FieldT& omega, const ntt_engine engine, const bool multicore)
+{
+    if (engine == ntt_engine::stockham) {
+        if (multicore) stockham_parallel_ntt(a, work, omega);
+        else stockham_serial_ntt(a, work, omega);
+    } else if (engine == ntt_engine::radix2) {
+        if (multicore) radix2_parallel_ntt(a, omega);
+        else radix2_serial_ntt(a, omega);
+    } else {
+        ntt_trace_span region(multicore ? "libfqfft_parallel_fft" : nullptr, ntt_trace_kind::opaque);
+        ntt_count_transforms(1, a.size());
+        if (multicore) _basic_parallel_radix2_FFT(a, omega);
+        else _basic_serial_radix2_FFT(a, omega);
+    }
+}
+
+/* Forward transforms of both operands; the radix-2 engine runs them as two lanes of one pass */
+template <typename FieldT>
+void engine_ntt_pair(std::vector<FieldT>& u, std::vector<FieldT>& v, std::vector<FieldT>& work, const FieldT& omega,
+                     const ntt_engine engine, const bool multicore)
+{
+    if (engine == ntt_engine::radix2) {
+        radix2_ntt_pair(u, v, omega, multicore);
+    } else {
+        engine_ntt(u, work, omega, engine, multicore);
+        engine_ntt(v, work, omega, engine, multicore);
+    }
+}
+
+/*
+ * Convolution at a size n = 3 * 2^k. The radix-3 pass doubles as the operand
+ * copy (and negacyclic twist), the three 2^k blocks go through the usual
+ * engine, and the inverse radix-3 pass writes c with 1/n folded in.
+ */
+template <typename FieldT>
+void polynomial_multiplication_radix3(const std::vector<FieldT>& a, const std::vector<FieldT>& b, std::vector<FieldT>& c,
+                                      const convolution_params<FieldT>& p, const ntt_engine engine, const bool multicore)
+{
+    const FieldT omega_m = p.omega^3;
+    const FieldT omega_m_inv = p.omega_inv^3;
+
+    std::vector<FieldT> u[3];
+    std::vector<FieldT> v[3];
+    std::vector<FieldT> work;
+
+    const bool square = (&a == &b);
+
+    radix3_split(u, a, p.n, p.omega, p.pre, multicore);
+    if (!square) radix3_split(v, b, p.n, p.omega, p.pre, multicore);
+    memory_checkpoint("radix-3 split");
+
+    for (size_t r = 0; r < 3; ++r) {
+        if (square) engine_ntt(u[r], work, omega_m, engine, multicore);
+        else engine_ntt_pair(u[r], v[r], work, omega_m, engine, multicore);
+        pointwise_product(u[r], square ? u[r] : v[r], u[r]);
+        std::vector<FieldT>().swap(v[r]);
+        engine_ntt(u[r], work, omega_m_inv, engine, multicore);
+    }
+    memory_checkpoint("radix-3 blocks");
+
+    radix3_merge(c, u, p.omega_inv, p.post, multicore);
+    memory_checkpoint("radix-3 merge");
+}
+
+/*
+ * Block transform size for an overlap-add linear product of a long_size and a
+ * short_size polynomial, or 0 when one zero-padded transform is cheaper.
+ * Cost is counted as n * (log n + 1) per transform (butterflies plus the pointwise pass).
+ * The single transform is priced at the 2^k or 3 * 2^k size convolution_size picks,
+ * with the radix-3 pass of a 3 * 2^k transform counted as two radix-2 levels.
+ */
+inline size_t overlap_add_block_size(const size_t long_size, const size_t short_size)
+{
+    const auto cost = [](const size_t n) {
+        if (n % 3 == 0) return double(n) * (libff::log2(n / 3) + 3);
+        return double(n) * (libff::log2(n) + 1);
+    };
+
+    const size_t m = get_smooth_size(long_size + short_size - 1);
+    double best_cost = 3 * cost(m);
+    size_t best = 0;
+
+    for (size_t n = libff::get_power_of_two(2 * short_size - 1); n < m; n *= 2) {
+        const size_t chunk = n - short_size + 1;
+        const size_t blocks = (long_size + chunk - 1) / chunk;
+        const double blocked = cost(n) + 2 * blocks * cost(n);
+        if (blocked < best_cost) {
+            best_cost = blocked;
+            best = n;
+        }
+    }
+    return best;
+}
+
+/*
+ * Linear product by overlap-add: the longer operand is cut into chunks of
+ * n - |short| + 1 coefficients, so each chunk's product with the short operand
+ * fits a size-n cyclic convolution. The short operand is transformed once
+ * (with 1/n folded in) and reused for every chunk.
+ * Chunks run one per thread when multicore is set; even and odd chunks are
+ * accumulated in separate rounds because neighbouring chunks overlap in c.
+ */
+template <typename FieldT>
+void polynomial_multiplication_overlap_add(const std::vector<FieldT>& a, const std::vector<FieldT>& b, std::vector<FieldT>& c,
+                                           const size_t n, const ntt_engine engine, const bool multicore)
+{
+    const std::vector<FieldT>& x = (a.size() >= b.size()) ? a : b;
+    const std::vector<FieldT>& h = (a.size() >= b.size()) ? b : a;
+    const size_t chunk = n - h.size() + 1;
+    const size_t blocks = (x.size() + chunk - 1) / chunk;
+
+    const FieldT omega = libff::get_root_of_unity<FieldT>(n);
+    const FieldT omega_inv = omega.inverse();
+
+    std::vector<FieldT> H;
+    std::vector<FieldT> work;
+    twisted_copy_serial(H, h, n, ntt_twist<FieldT>(FieldT(n).inverse(), FieldT::one()));
+    engine_ntt(H, work, omega, engine, false);
+
+    c.assign(x.size() + h.size() - 1, FieldT::zero());
+    memory_checkpoint("short operand NTT");
+
+    for (size_t parity = 0; parity < 2; ++parity) {
+        ntt_trace_span region(multicore ? "overlap_add" : nullptr, ntt_trace_kind::region, parity);
+        #pragma omp parallel if(multicore)
+        {
+            std::vector<FieldT> u(n);
+            std::vector<FieldT> w;
+
+            #pragma omp for schedule(dynamic) nowait
+            for (size_t j = parity; j < blocks; j += 2) {
+                ntt_trace_span work(multicore ? "block" : nullptr, ntt_trace_kind::work, j);
+                const size_t offset = j * chunk;
+                const size_t len = std::min(chunk, x.size() - offset);
+                std::copy(x.begin() + offset, x.begin() + offset + len, u.begin());
+                std::fill(u.begin() + len, u.end(), FieldT::zero());
+
+                engine_ntt(u, w, omega, engine, false);
+                std::transform(u.begin(), u.end(), H.begin(), u.begin(), std::multiplies<FieldT>());
+                ntt_count_pass();
+                engine_ntt(u, w, omega_inv, engine, false);
+
+                const size_t out = std::min(n, c.size() - offset);
+                for (size_t i = 0; i < out; ++i) c[offset + i] += u[i];
+            }
+            ntt_trace_barrier(multicore);
+        }
+    }
+    memory_checkpoint("overlap-add blocks");
+}
+
+/*
+ * Bytes polynomial_multiplication_on_FFT_serial/parallel hold at their peak,
+ * inputs and output included. The one-transform paths keep u, v and c of n
+ * elements (v is skipped when squaring), plus one more n of scratch inside
+ * libfqfft's parallel FFT; overlap-add keeps the transformed short operand, the
+ * output and two block buffers per thread. A non-zero `block` prices
+ * overlap-add at that transform size instead of the automatic choice.
+ */
+template <typename FieldT>
+size_t polynomial_multiplication_memory(const convolution_kind kind, const size_t a_size, const size_t b_size,
+                                        const ntt_engine engine, const bool multicore, const bool square, const size_t block = 0)
+{
+    size_t elements = a_size + (square ? 0 : b_size);
+    const size_t blocked = block ? block
+                         : kind == convolution_kind::linear ? overlap_add_block_size(std::max(a_size, b_size), std::min(a_size, b_size))
+                         : 0;
+    if (blocked) {
+        const size_t threads = multicore ? omp_get_max_threads() : 1;
+        elements += blocked + (a_size + b_size - 1) + 2 * blocked * threads;
+    } else {
+        const size_t n = convolution_size(kind, a_size, b_size);
+        elements += (square ? 2 : 3) * n;
+        if (engine == ntt_engine::libfqfft && multicore) elements += n;
+    }
+    return elements * sizeof(FieldT);
+}
+
+/* Polynomial Multiplication via FFT with output parameter */
+template <typename FieldT>
+void polynomial_multiplication_on_FFT_serial(const std::vector<FieldT>& a, const std::vector<FieldT>& b, std::vector<FieldT>& c,
+                                             const convolution_kind kind, const ntt_engine engine)
+{
+    c.clear();
+    if (a.empty() || b.empty()) return;
+
+    if (kind == convolution_kind::linear) {
+        const size_t block = overlap_add_block_size(std::max(a.size(), b.size()), std::min(a.size(), b.size()));
+        if (block) {
+            polynomial_multiplication_overlap_add(a, b, c, block, engine, false);
+            _condense(c);
+            return;
+        }
+    }
+
+    const convolution_params<FieldT> p(kind, convolution_size(kind, a.size(), b.size()));
+
+    if (p.n % 3 == 0) {
+        polynomial_multiplication_radix3(a, b, c, p, engine, false);
+        c.resize(a.size() + b.size() - 1);
+        _condense(c);
+        return;
+    }
+
+    /* Squaring: the operands are one buffer, so only u is transformed and v is never allocated */
+    const bool square = (&a == &b);
+    std::vector<FieldT> u;
+    std::vector<FieldT> v;
+
+    if (engine == ntt_engine::stockham) {
+        /* c is only written after the pointwise product, so it serves as the ping-pong buffer until then */
+        twisted_copy_serial(u, a, p.n, ntt_twist<FieldT>());
+        stockham_serial_ntt(u, c, p.omega, p.pre);
+        if (!square) {
+            twisted_copy_serial(v, b, p.n, ntt_twist<FieldT>());
+            stockham_serial_ntt(v, c, p.omega, p.pre);
+        }
+        memory_checkpoint("forward NTT");
+        pointwise_product(u, square ? u : v, c);
+        memory_checkpoint("pointwise");
+        stockham_serial_ntt(c, u, p.omega_inv, ntt_twist<FieldT>(), p.post);
+        memory_checkpoint("inverse NTT");
+    } else {
+        /* The in-place kernels cannot take the twist, so it rides on the copy-in and the 1/n pass */
+        twisted_copy_serial(u, a, p.n, p.pre);
+        if (!square) twisted_copy_serial(v, b, p.n, p.pre);
+        c.resize(p.n, FieldT::zero());
+
+        if (square) engine_ntt(u, v, p.omega, engine, false);
+        else engine_ntt_pair(u, v, c, p.omega, engine, false);
+        memory_checkpoint("forward NTT");
+
+        pointwise_product(u, square ? u : v, c);
+        memory_checkpoint("pointwise");
+
+        engine_ntt(c, u, p.omega_inv, engine, false);
+        twisted_copy_serial(c, c, p.n, p.post);
+        memory_checkpoint("inverse NTT");
+    }
+
+    if (kind == convolution_kind::linear) c.resize(a.size() + b.size() - 1);
+    _condense(c);
+
+    return;
+}
+
+/* Polynomial Multiplication via FFT with output parameter */
+template <typename FieldT>
+void polynomial_multiplication_on_FFT_parallel(const std::vector<FieldT>& a, const std::vector<FieldT>& b, std::vector<FieldT>& c,
+                                               const convolution_kind kind, const ntt_engine engine)
+{
+    c.clear();
+    if (a.empty() || b.empty()) return;
+
+    if (kind == convolution_kind::linear) {
+        const size_t block = overlap_add_block_size(std::max(a.size(), b.size()), std::min(a.size(), b.size()));
+        if (block) {
+            polynomial_multiplication_overlap_add(a, b, c, block, engine, true);
+            _condense(c);
+            return;
+        }
+    }
+
+    const convolution_params<FieldT> p(kind, convolution_size(kind, a.size(), b.size()));
+
+    if (p.n % 3 == 0) {
+        polynomial_multiplication_radix3(a, b, c, p, engine, true);
+        c.resize(a.size() + b.size() - 1);
+        _condense(c);
+        return;
+    }
+
+    /* Squaring: the operands are one buffer, so only u is transformed and v is never allocated */
+    const bool square = (&a == &b);
+    std::vector<FieldT> u;
+    std::vector<FieldT> v;
+
+    if (engine == ntt_engine::stockham) {
+        twisted_copy_parallel(u, a, p.n, ntt_twist<FieldT>());
+        stockham_parallel_ntt(u, c, p.omega, p.pre);
+        if (!square) {
+            twisted_copy_parallel(v, b, p.n, ntt_twist<FieldT>());
+            stockham_parallel_ntt(v, c, p.omega, p.pre);
+        }
+        memory_checkpoint("forward NTT");
+        pointwise_product(u, square ? u : v, c);
+        memory_checkpoint("pointwise");
+        stockham_parallel_ntt(c, u, p.omega_inv, ntt_twist<FieldT>(), p.post);
+        memory_checkpoint("inverse NTT");
+    } else {
+        twisted_copy_parallel(u, a, p.n, p.pre);
+        if (!square) twisted_copy_parallel(v, b, p.n, p.pre);
+        c.resize(p.n, FieldT::zero());
+
+        if (square) engine_ntt(u, v, p.omega, engine, true);
+        else engine_ntt_pair(u, v, c, p.omega, engine, true);
+        memory_checkpoint("forward NTT");
+
+        pointwise_product(u, square ? u : v, c);
+        memory_checkpoint("pointwise");
+
+        engine_ntt(c, u, p.omega_inv, engine, true);
+        twisted_copy_parallel(c, c, p.n, p.post);
+        memory_checkpoint("inverse NTT");
+    }
+
+    if (kind == convolution_kind::linear) c.resize(a.size() + b.size() - 1);
+    _condense(c);
+
+    return;
+}
+
+/*
+ * Fixed multiplier kept in evaluation form: the forward transform of b for one
+ * transform size and convolution kind, with 1/n (and for negacyclic the psi
+ * twist) already folded in. Every product with it then costs one forward NTT,
+ * a pointwise product and one inverse NTT.
+ * For 3 * 2^k sizes the evaluations are the three radix-3 blocks back to back.
+ */
+template <typename FieldT>
+struct prepared_operand
+{
+    convolution_kind kind;
+    size_t b_size;
+    convolution_params<FieldT> params;
+    std::vector<FieldT> evaluations;
+};
+
+/* Longest a that fits one transform of the prepared operand */
+template <typename FieldT>
+size_t prepared_max_a_size(const prepared_operand<FieldT>& prep)
+{
+    if (prep.kind == convolution_kind::linear) return prep.params.n - prep.b_size + 1;
+    return prep.params.n;
+}
+
+/*
+ * Bytes a product with a prepared operand of transform size n holds at its
+ * peak: a, the evaluations, b when it is still in memory (-P), and u and c of
+ * n (plus libfqfft's parallel scratch), or for a linear a longer than the
+ * prepared size the overlap-add output and three block buffers per thread.
+ */
+template <typename FieldT>
+size_t prepared_multiplication_memory(const convolution_kind kind, const size_t a_size, const size_t b_size, const size_t n,
+                                      const bool b_held, const ntt_engine engine, const bool multicore)
+{
+    size_t elements = a_size + n + (b_held ? b_size : 0);
+    const size_t chunk = (kind == convolution_kind::linear) ? n - b_size + 1 : n;
+    if (kind == convolution_kind::linear && a_size > chunk) {
+        const size_t threads = multicore ? omp_get_max_threads() : 1;
+        elements += (a_size + b_size - 1) + 3 * n * threads;
+    } else {
+        elements += 2 * n;
+        if (engine == ntt_engine::libfqfft && multicore) elements += n;
+    }
+    return elements * sizeof(FieldT);
+}
+
+/* Prepare b for products with polynomials of up to a_size coefficients */
+template <typename FieldT>
+void prepare_operand(const std::vector<FieldT>& b, const convolution_kind kind, const size_t a_size,
+                     prepared_operand<FieldT>& prep, const ntt_engine engine, const bool multicore)
+{
+    if (b.empty()) throw DomainSizeException("expected a non-empty operand");
+
+    prep.kind = kind;
+    prep.b_size = b.size();
+    prep.params = convolution_params<FieldT>(kind, convolution_size(kind, std::max<size_t>(a_size, 1), b.size()));
+
+    const convolution_params<FieldT>& p = prep.params;
+    const ntt_twist<FieldT> pre(FieldT(p.n).inverse(), p.pre.step);
+    std::vector<FieldT> work;
+
+    if (p.n % 3 == 0) {
+        const size_t m = p.n / 3;
+        const FieldT omega_m = p.omega^3;
+        std::vector<FieldT> y[3];
+        radix3_split(y, b, p.n, p.omega, pre, multicore);
+        prep.evaluations.resize(p.n);
+        for (size_t r = 0; r < 3; ++r) {
+            engine_ntt(y[r], work, omega_m, engine, multicore);
+            std::copy(y[r].begin(), y[r].end(), prep.evaluations.begin() + r * m);
+        }
+        return;
+    }
+
+    if (engine == ntt_engine::stockham) {
+        if (multicore) twisted_copy_parallel(prep.evaluations, b, p.n, ntt_twist<FieldT>());
+        else twisted_copy_serial(prep.evaluations, b, p.n, ntt_twist<FieldT>());
+        if (multicore) stockham_parallel_ntt(prep.evaluations, work, p.omega, pre);
+        else stockham_serial_ntt(prep.evaluations, work, p.omega, pre);
+    } else {
+        if (multicore) twisted_copy_parallel(prep.evaluations, b, p.n, pre);
+        else twisted_copy_serial(prep.evaluations, b, p.n, pre);
+        engine_ntt(prep.evaluations, work, p.omega, engine, multicore);
+    }
+}
+
+/* c = a * prepared as one size-n convolution (|a| <= n); c gets n entries */
+template <typename FieldT>
+void prepared_convolution(const std::vector<FieldT>& a, const prepared_operand<FieldT>& prep, std::vector<FieldT>& c,
+                          const ntt_engine engine, const bool multicore)
+{
+    const convolution_params<FieldT>& p = prep.params;
+    const ntt_twist<FieldT> post(FieldT::one(), p.post.step);
+    std::vector<FieldT> work;
+
+    if (p.n % 3 == 0) {
+        const size_t m = p.n / 3;
+        const FieldT omega_m = p.omega^3;
+        const FieldT omega_m_inv = p.omega_inv^3;
+        std::vector<FieldT> u[3];
+        radix3_split(u, a, p.n, p.omega, p.pre, multicore);
+        for (size_t r = 0; r < 3; ++r) {
+            engine_ntt(u[r], work, omega_m, engine, multicore);
+            std::transform(u[r].begin(), u[r].end(), prep.evaluations.begin() + r * m, u[r].begin(), std::multiplies<FieldT>());
+            ntt_count_pass();
+            engine_ntt(u[r], work, omega_m_inv, engine, multicore);
+        }
+        radix3_merge(c, u, p.omega_inv, post, multicore);
+        return;
+    }
+
+    std::vector<FieldT> u;
+    if (engine == ntt_engine::stockham) {
+        if (multicore) twisted_copy_parallel(u, a, p.n, ntt_twist<FieldT>());
+        else twisted_copy_serial(u, a, p.n, ntt_twist<FieldT>());
+        if (multicore) stockham_parallel_ntt(u, c, p.omega, p.pre);
+        else stockham_serial_ntt(u, c, p.omega, p.pre);
+        pointwise_product(u, prep.evaluations, c);
+        if (multicore) stockham_parallel_ntt(c, u, p.omega_inv, ntt_twist<FieldT>(), post);
+        else stockham_serial_ntt(c, u, p.omega_inv, ntt_twist<FieldT>(), post);
+    } else {
+        if (multicore) twisted_copy_parallel(u, a, p.n, p.pre);
+        else twisted_copy_serial(u, a, p.n, p.pre);
+        engine_ntt(u, work, p.omega, engine, multicore);
+        pointwise_product(u, prep.evaluations, c);
+        engine_ntt(c, work, p.omega_inv, engine, multicore);
+        if (!post.is_identity()) {
+            if (multicore) twisted_copy_parallel(c, c, p.n, post);
+            else twisted_copy_serial(c, c, p.n, post);
+        }
+    }
+}
+
+/*
+ * c = a * b for a prepared b. A linear product with an a longer than the
+ * prepared size falls back to overlap-add over the stored evaluations, one
+ * chunk per thread in multicore mode; cyclic and negacyclic need |a| <= n.
+ */
+template <typename FieldT>
+void polynomial_multiplication_on_prepared(const std::vector<FieldT>& a, const prepared_operand<FieldT>& prep, std::vector<FieldT>& c,
+                                        const ntt_engine engine, const bool multicore)
+{
+    c.clear();
+    if (a.empty()) return;
+
+    const size_t chunk = prepared_max_a_size(prep);
+    if (a.size() <= chunk) {
+        prepared_convolution(a, prep, c, engine, multicore);
+        if (prep.kind == convolution_kind::linear) c.resize(a.size() + prep.b_size - 1);
+        _condense(c);
+        return;
+    }
+    if (prep.kind != convolution_kind::linear) throw DomainSizeException("expected a.size() <= prepared transform size");
+
+    const size_t n = prep.params.n;
+    const size_t blocks = (a.size() + chunk - 1) / chunk;
+    c.assign(a.size() + prep.b_size - 1, FieldT::zero());
+
+    for (size_t parity = 0; parity < 2; ++parity) {
+        ntt_trace_span region(multicore ? "prepared_overlap_add" : nullptr, ntt_trace_kind::region, parity);
+        #pragma omp parallel if(multicore)
+        {
+            std::vector<FieldT> x;
+            std::vector<FieldT> y;
+
+            #pragma omp for schedule(dynamic) nowait
+            for (size_t j = parity; j < blocks; j += 2) {
+                ntt_trace_span work(multicore ? "block" : nullptr, ntt_trace_kind::work, j);
+                const size_t offset = j * chunk;
+                const size_t len = std::min(chunk, a.size() - offset);
+                x.assign(a.begin() + offset, a.begin() + offset + len);
+
+                prepared_convolution(x, prep, y, engine, false);
+
+                const size_t out = std::min(n, c.size() - offset);
+                for (size_t i = 0; i < out; ++i) c[offset + i] += y[i];
+            }
+            ntt_trace_barrier(multicore);
+        }
+    }
+    _condense(c);
+}
+
+template <typename FieldT>
+void polynomial_multiplication_on_prepared_serial(const std::vector<FieldT>& a, const prepared_operand<FieldT>& prep, std::vector<FieldT>& c, const ntt_engine engine)
+{
+    polynomial_multiplication_on_prepared(a, prep, c, engine, false);
+}
+
+template <typename FieldT>
+void polynomial_multiplication_on_prepared_parallel(const std::vector<FieldT>& a, const prepared_operand<FieldT>& prep, std::vector<FieldT>& c, const ntt_engine engine)
+{
+    polynomial_multiplication_on_prepared(a, prep, c, engine, true);
+}
+
+/*
+ * Prepared operands are stored in the polynomial file format: two header
+ * elements (convolution kind, |b|) followed by the n evaluations.
+ */
+template <typename FieldT>
+bool write_prepared_operand(const std::string& filename, const prepared_operand<FieldT>& prep)
+{
+    std::vector<FieldT> poly;
+    poly.reserve(prep.evaluations.size() + 2);
+    poly.emplace_back(static_cast<unsigned long>(prep.kind));
+    poly.emplace_back(static_cast<unsigned long>(prep.b_size));
+    poly.insert(poly.end(), prep.evaluations.begin(), prep.evaluations.end());
+    return write_polynomial(filename, poly);
+}
+
+template <typename FieldT>
+bool read_prepared_operand(const std::string& filename, prepared_operand<FieldT>& prep)
+{
+    std::vector<FieldT> poly;
+    if (!read_polynomial(filename, poly)) return false;
+    if (poly.size() < 3) {
+        std::cerr << "[-] " << filename << " is not a prepared operand" << std::endl;
+        return false;
+    }
+
+    const unsigned long kind = poly[0].as_bigint().as_ulong();
+    const size_t b_size = poly[1].as_bigint().as_ulong();
+    const size_t n = poly.size() - 2;
+    const bool smooth = libff::is_power_of_2(n) || (n % 3 == 0 && libff::is_power_of_2(n / 3));
+    const bool valid = (kind <= static_cast<unsigned long>(convolution_kind::linear)) && b_size >= 1 && b_size <= n &&
+                       (kind == static_cast<unsigned long>(convolution_kind::linear) ? smooth : libff::is_power_of_2(n));
+    if (!valid) {
+        std::cerr << "[-] " << filename << " has an invalid prepared operand header" << std::endl;
+        return false;
+    }
+
+    prep.kind = static_cast<convolution_kind>(kind);
+    prep.b_size = b_size;
+    prep.params = convolution_params<FieldT>(prep.kind, n);
+    prep.evaluations.assign(poly.begin() + 2, poly.end());
+    return true;
+}
+
+/*
+ * Transform size from which a multiplication inside a batch gets the whole
+ * machine (parallel transforms) instead of one core. Below it, and as long as
+ * there are at least as many such pairs as threads, whole multiplications are
+ * spread across cores, which avoids per-transform fork/join and barriers.
+ */
+const size_t batch_split_size = 1ul << 20;
+
+/* cs[i] = as[i] * bs[i] for every pair */
+template <typename FieldT>
+void polynomial_multiplication_batch(const std::vector<std::vector<FieldT> >& as, const std::vector<std::vector<FieldT> >& bs,
+                                     std::vector<std::vector<FieldT> >& cs, const convolution_kind kind, const ntt_engine engine,
+                                     const bool multicore)
+{
+    if (as.size() != bs.size()) throw DomainSizeException("expected as.size() == bs.size()");
+    cs.resize(as.size());
+
+    std::vector<size_t> small;
+    std::vector<size_t> large;
+    for (size_t i = 0; i < as.size(); ++i) {
+        if (as[i].empty() || bs[i].empty()) {
+            cs[i].clear();
+            continue;
+        }
+        if (convolution_size(kind, as[i].size(), bs[i].size()) < batch_split_size) small.push_back(i);
+        else large.push_back(i);
+    }
+
+    /* Too few small pairs to occupy every core: give each one the whole machine instead */
+    if (!multicore || small.size() < static_cast<size_t>(omp_get_max_threads())) {
+        large.insert(large.end(), small.begin(), small.end());
+        small.clear();
+    }
+
+    {
+        ntt_trace_span region(small.empty() ? nullptr : "batch_small_pairs", ntt_trace_kind::region);
+        #pragma omp parallel for schedule(dynamic)
+        for (size_t j = 0; j < small.size(); ++j) {
+            ntt_trace_span work("pair", ntt_trace_kind::work, small[j]);
+            const size_t i = small[j];
+            polynomial_multiplication_on_FFT_serial(as[i], bs[i], cs[i], kind, engine);
+        }
+    }
+
+    for (const size_t i : large) {
+        if (multicore) polynomial_multiplication_on_FFT_parallel(as[i], bs[i], cs[i], kind, engine);
+        else polynomial_multiplication_on_FFT_serial(as[i], bs[i], cs[i], kind, engine);
+    }
+}
+
+/* Squaring: one forward NTT, a pointwise square and one inverse NTT */
+template <typename FieldT>
+void polynomial_squaring_on_FFT_serial(const std::vector<FieldT>& a, std::vector<FieldT>& c, const convolution_kind kind, const ntt_engine engine)
+{
+    polynomial_multiplication_on_FFT_serial(a, a, c, kind, engine);
+}
+
+template <typename FieldT>
+void polynomial_squaring_on_FFT_parallel(const std::vector<FieldT>& a, std::vector<FieldT>& c, const convolution_kind kind, const ntt_engine engine)
+{
+    polynomial_multiplication_on_FFT_parallel(a, a, c, kind, engine);
+}
+
+#endif // POLYNOMIAL_MULTIPLICATION_HPP
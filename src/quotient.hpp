@@ -0,0 +1,131 @@
+#ifndef QUOTIENT_HPP
+#define QUOTIENT_HPP
+
+#include <libfqfft/tools/exceptions.hpp>
+
+#include "utils.hpp"
+#include "ntt.hpp"
+#include "polynomial_multiplication.hpp"
+
+/* In-place size-k DFT of a[0 .. k), k a power of two, with roots[j] = w^j for j < k/2 */
+template <typename FieldT>
+void small_dft(FieldT* a, const size_t k, const std::vector<FieldT>& roots)
+{
+    const size_t logk = log2(k);
+    for (size_t i = 0; i < k; ++i)
+    {
+        const size_t ri = libff::bitreverse(i, logk);
+        if (i < ri) std::swap(a[i], a[ri]);
+    }
+    for (size_t m = 1; m < k; m *= 2)
+        for (size_t j0 = 0; j0 < k; j0 += 2 * m)
+            for (size_t j = 0; j < m; ++j)
+            {
+                const FieldT t = roots[j * (k / (2 * m))] * a[j0 + j + m];
+                a[j0 + j + m] = a[j0 + j] - t;
+                a[j0 + j] += t;
+            }
+}
+
+/* Size-n transforms of every lane; the radix-2 engine runs them as lanes of one pass */
+template <typename FieldT>
+void lane_transforms(std::vector<std::vector<FieldT> >& lanes, const FieldT& omega, const ntt_engine engine, const bool multicore)
+{
+    if (engine == ntt_engine::radix2) {
+        std::vector<FieldT*> x(lanes.size());
+        for (size_t r = 0; r < lanes.size(); ++r) x[r] = lanes[r].data();
+        radix2_ntt_lanes(x.data(), lanes.size(), lanes[0].size(), omega, multicore);
+        return;
+    }
+    std::vector<FieldT> work;
+    for (auto& lane : lanes) engine_ntt(lane, work, omega, engine, multicore);
+}
+
+/*
+ * h = p / Z_H with Z_H = x^n - 1, from the evaluations of p on the coset g<w>
+ * of size N = k * n, p_evals[j] = p(g w^j) (the input of libfqfft's
+ * divide_by_Z_on_coset followed by icosetFFT).
+ *
+ * The size-N inverse transform is split into k size-n lane transforms and one
+ * radix-k stage: point j = r + k i lies in lane r, and on lane r Z_H is the
+ * constant g^n w_k^r - 1. So the division is one multiplier per lane, and it is
+ * folded together with 1/N, the twiddles w^-rs and the coset untwist g^-t into
+ * the radix-k stage. Apart from the k lane transforms, p_evals and h are each
+ * touched once.
+ */
+template <typename FieldT>
+void coset_quotient(const std::vector<FieldT>& p_evals, const size_t n, const size_t blowup, const FieldT& shift,
+                    std::vector<FieldT>& h, const ntt_engine engine, const bool multicore)
+{
+    if (n == 0 || (n & (n - 1)) != 0) throw DomainSizeException("expected a power-of-two vanishing domain");
+    if (blowup == 0 || (blowup & (blowup - 1)) != 0) throw DomainSizeException("expected a power-of-two blowup");
+
+    const size_t k = blowup;
+    const size_t N = k * n;
+    if (p_evals.size() != N) throw DomainSizeException("expected p_evals.size() == blowup * n");
+
+    const FieldT omega = libff::get_root_of_unity<FieldT>(N);
+    const FieldT omega_n = omega^k;
+    const FieldT omega_k = omega^n;
+    const FieldT G = shift^n;
+
+    /* Per-lane constants; z[r] becomes 1 / (N Z_r) */
+    std::vector<FieldT> coset_inv(k);
+    std::vector<FieldT> z(k);
+    std::vector<FieldT> g_pow_inv(k);
+    std::vector<FieldT> roots_inv(k / 2);
+    FieldT c = shift;
+    FieldT gq = FieldT::one();
+    FieldT wr = FieldT::one();
+    for (size_t r = 0; r < k; ++r) {
+        coset_inv[r] = c;
+        z[r] = G * wr - FieldT::one();
+        if (z[r].is_zero()) throw InvalidSizeException("expected the coset to avoid the vanishing set");
+        z[r] *= FieldT(N);
+        g_pow_inv[r] = gq;
+        if (r < k / 2) roots_inv[r] = wr;
+        c *= omega;
+        gq *= G;
+        wr *= omega_k;
+    }
+    batch_inverse(coset_inv, false);
+    batch_inverse(z, false);
+    batch_inverse(g_pow_inv, false);
+    batch_inverse(roots_inv, false);
+
+    /* Lane r gathers the points r + k i */
+    std::vector<std::vector<FieldT> > lanes(k, std::vector<FieldT>(n));
+    #pragma omp parallel for if(multicore)
+    for (size_t i = 0; i < n; ++i)
+        for (size_t r = 0; r < k; ++r) lanes[r][i] = p_evals[r + k * i];
+
+    lane_transforms(lanes, omega_n.inverse(), engine, multicore);
+
+    /* Radix-k stage: lane r times (g w^r)^-s / (N Z_r), inverse DFT over r, then G^-q */
+    h.resize(N);
+    #pragma omp parallel if(multicore)
+    {
+        const size_t nthreads = omp_get_num_threads();
+        const size_t tid = omp_get_thread_num();
+        const size_t chunk = (n + nthreads - 1) / nthreads;
+        const size_t begin = std::min(n, tid * chunk);
+        const size_t end = std::min(n, begin + chunk);
+
+        std::vector<FieldT> b(k);
+        std::vector<FieldT> factor(k);
+        for (size_t r = 0; r < k; ++r) factor[r] = z[r] * (coset_inv[r]^begin);
+
+        for (size_t s = begin; s < end; ++s) {
+            for (size_t r = 0; r < k; ++r) {
+                b[r] = lanes[r][s] * factor[r];
+                factor[r] *= coset_inv[r];
+            }
+            small_dft(b.data(), k, roots_inv);
+            for (size_t q = 0; q < k; ++q) h[s + n * q] = b[q] * g_pow_inv[q];
+        }
+    }
+
+    _condense(h);
+}
+
+#endif // QUOTIENT_HPP
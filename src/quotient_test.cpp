@@ -0,0 +1,135 @@
+#include "utils.hpp"
+#include "quotient.hpp"
+
+/* H = P / Z_H from P on a coset k times larger than H = <w_n>, n = 2^log_n, against the separate-pass libfqfft pipeline */
+int test(int log_n, const std::vector<size_t>& blowups, const ntt_engine engine, const bool multicore)
+{
+    const size_t n = 1ul << log_n;
+    const FieldT shift = FieldT::multiplicative_generator;
+
+    for (const size_t blowup : blowups) {
+        const size_t N = blowup * n;
+        std::cout << "[i] Blowup : " << blowup << " (coset of " << N << ")" << std::endl;
+
+        /* P = H (x^n - 1) for a random H of N - n coefficients */
+        std::vector<FieldT> expected(N - n);
+        for (auto& x : expected) x = FieldT::random_element();
+        std::vector<FieldT> p(N, FieldT::zero());
+        for (size_t t = 0; t < N - n; ++t) {
+            p[t + n] += expected[t];
+            p[t] -= expected[t];
+        }
+        _condense(expected);
+
+        /* The quotient takes P on the coset, as divide_by_Z_on_coset does */
+        const FieldT omega = libff::get_root_of_unity<FieldT>(N);
+        std::vector<FieldT> p_evals(p);
+        _multiply_by_coset(p_evals, shift);
+        if (multicore) _basic_parallel_radix2_FFT(p_evals, omega);
+        else _basic_serial_radix2_FFT(p_evals, omega);
+
+        std::vector<FieldT> u;
+        std::vector<FieldT> h;
+
+        // Separate Pass Timing Measure
+        {
+        std::cout << "[*] processing Separate Pass Quotient";
+        std::cout.flush();
+        auto start_time = std::chrono::high_resolution_clock::now();
+        u = p_evals;
+        std::vector<FieldT> z_inv(blowup);
+        const FieldT G = shift^n;
+        const FieldT omega_k = omega^n;
+        for (size_t r = 0; r < blowup; ++r) z_inv[r] = (G * (omega_k^r) - FieldT::one()).inverse();
+        #pragma omp parallel for if(multicore)
+        for (size_t j = 0; j < N; ++j) u[j] *= z_inv[j % blowup];
+
+        if (multicore) _basic_parallel_radix2_FFT(u, omega.inverse());
+        else _basic_serial_radix2_FFT(u, omega.inverse());
+        const FieldT N_inv = FieldT(N).inverse();
+        #pragma omp parallel for if(multicore)
+        for (size_t j = 0; j < N; ++j) u[j] *= N_inv;
+        _multiply_by_coset(u, shift.inverse());
+        _condense(u);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        auto minutes = duration.count() / 60000;
+        auto seconds = (duration.count() % 60000) / 1000;
+        auto milliseconds = duration.count() % 1000;
+
+        std::cout << std::dec;
+        std::cout << std::setw(_print_align) << std::left << "\r[+] Separate Pass Quotient process complete"
+                  << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+        }
+
+        // Fused Timing Measure
+        {
+        std::cout << "[*] processing Fused Quotient";
+        std::cout.flush();
+        auto start_time = std::chrono::high_resolution_clock::now();
+        coset_quotient(p_evals, n, blowup, shift, h, engine, multicore);
+        auto end_time = std::chrono::high_resolution_clock::now();
+        auto duration = std::chrono::duration_cast<std::chrono::milliseconds>(end_time - start_time);
+        auto minutes = duration.count() / 60000;
+        auto seconds = (duration.count() % 60000) / 1000;
+        auto milliseconds = duration.count() % 1000;
+
+        std::cout << std::dec;
+        std::cout << std::setw(_print_align) << std::left << "\r[+] Fused Quotient process complete"
+                  << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
+        }
+
+        if (u != expected) std::cout << "Separate Pass Result is not the quotient" << std::endl;
+        if (h != expected) std::cout << "Fused Result is not the quotient" << std::endl;
+    }
+
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    int opt;
+    std::vector<int> sizes;
+    std::vector<size_t> blowups;
+    bool multicore = false;
+    ntt_engine engine = ntt_engine::libfqfft;
+
+    while ((opt = getopt(argc, argv, "n:k:me:")) != -1) {
+        switch (opt) {
+            case 'n':
+                sizes.push_back(std::stoi(optarg));
+                break;
+            case 'k':
+                blowups.push_back(std::stoul(optarg));
+                if (blowups.back() == 0 || (blowups.back() & (blowups.back() - 1)) != 0) {
+                    std::cerr << "[-] Invalid blowup " << optarg << " (expected a power of two)" << std::endl;
+                    return 1;
+                }
+                break;
+            case 'm':
+                multicore = true;
+                break;
+            case 'e':
+                if (parse_ntt_engine(optarg, engine)) break;
+                std::cerr << "[-] Unknown engine " << optarg << " (libfqfft|stockham|radix2)" << std::endl;
+                return 1;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-m] [-e libfqfft|stockham|radix2] [-k blowup]... [-n k]..." << std::endl;
+                return 1;
+        }
+    }
+
+    if (sizes.empty()) sizes = {16, 20};
+    if (blowups.empty()) blowups = {2, 4, 8};
+
+    bls12_381_pp::init_public_params();
+    std::cout << "[i] Mode : " << (multicore ? "Parallel" : "Serial") << std::endl;
+    std::cout << "\t- engine : " << ntt_engine_name(engine) << std::endl;
+
+    for (int i : sizes) {
+        std::cout << "# Test " << i << std::endl;
+        test(i, blowups, engine, multicore);
+        std::cout << std::endl;
+    }
+
+    return 0;
+}
@@ -1,3 +1,10 @@
+#include <cstring>
+#include <mutex>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <proc/readproc.h>
+#include <proc/sysinfo.h>
+
 #include "utils.hpp"
 
 // Function to generate random polynomial and write to file
@@ -143,3 +150,94 @@ bool write_polynomial(const std::string& filename, const std::vector<FieldT>& po
               << std::setw(10) << std::right << " (" << minutes << "m " << seconds << "s " << milliseconds << "ms)" << std::endl;
     return true;
 }
+
+
+/* Function to check whether two polynomial files hold the same coefficients (same path, or byte-identical content) */
+bool same_polynomial_file(const std::string& filename_a, const std::string& filename_b)
+{
+    if (filename_a == filename_b) return true;
+
+    std::ifstream file_a(filename_a, std::ios::binary | std::ios::ate);
+    std::ifstream file_b(filename_b, std::ios::binary | std::ios::ate);
+    if (!file_a.is_open() || !file_b.is_open()) return false;
+    if (file_a.tellg() != file_b.tellg()) return false;
+
+    file_a.seekg(0);
+    file_b.seekg(0);
+
+    std::vector<char> buffer_a(1 << 20);
+    std::vector<char> buffer_b(1 << 20);
+    while (file_a && file_b) {
+        file_a.read(buffer_a.data(), buffer_a.size());
+        file_b.read(buffer_b.data(), buffer_b.size());
+        if (file_a.gcount() != file_b.gcount()) return false;
+        if (!std::equal(buffer_a.begin(), buffer_a.begin() + file_a.gcount(), buffer_b.begin())) return false;
+    }
+    return true;
+}
+
+/* Number of coefficients in a binary polynomial file, 0 when it cannot be opened */
+size_t polynomial_file_size(const std::string& filename)
+{
+    std::ifstream input_file(filename, std::ios::binary | std::ios::ate);
+    if (!input_file.is_open()) return 0;
+    return static_cast<size_t>(input_file.tellg()) / sizeof(bigint<4>::data);
+}
+
+memory_usage get_memory_usage()
+{
+    proc_t self;
+    std::memset(&self, 0, sizeof(self));
+    look_up_our_self(&self);
+
+    rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+
+    memory_usage m;
+    m.rss_kb = static_cast<size_t>(self.rss) * (sysconf(_SC_PAGESIZE) / 1024);
+    m.peak_kb = std::max(m.rss_kb, static_cast<size_t>(usage.ru_maxrss));
+    return m;
+}
+
+/* MemAvailable from /proc/meminfo: what can be allocated without swapping */
+size_t get_available_memory_kb()
+{
+    meminfo();
+    return kb_main_available;
+}
+
+static bool memory_report_enabled = false;
+static std::vector<std::pair<std::string, memory_usage> > memory_report;
+static std::mutex memory_report_mutex;   // batch jobs reach their checkpoints concurrently
+
+void enable_memory_report()
+{
+    memory_report_enabled = true;
+}
+
+/* One row per phase, in first-seen order: a phase passed again (every batch job) keeps the largest rss and peak */
+void memory_checkpoint(const std::string& phase)
+{
+    if (!memory_report_enabled) return;
+    std::lock_guard<std::mutex> lock(memory_report_mutex);
+    const memory_usage m = get_memory_usage();
+    for (auto& entry : memory_report) {
+        if (entry.first != phase) continue;
+        entry.second.rss_kb = std::max(entry.second.rss_kb, m.rss_kb);
+        entry.second.peak_kb = std::max(entry.second.peak_kb, m.peak_kb);
+        return;
+    }
+    memory_report.emplace_back(phase, m);
+}
+
+void print_memory_report()
+{
+    if (memory_report.empty()) return;
+    std::cout << "[i] Memory (MB)" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    for (const auto& entry : memory_report)
+        std::cout << "\t - " << std::setw(20) << std::left << entry.first << std::right
+                  << " : rss " << std::setw(10) << entry.second.rss_kb / 1024.0
+                  << ", peak " << std::setw(10) << entry.second.peak_kb / 1024.0 << std::endl;
+    std::cout << std::defaultfloat;
+}
@@ -28,7 +28,25 @@ bool read_polynomial_from_file(const std::string& filename, std::vector<FieldT>&
 bool read_polynomial(const std::string& filename, std::vector<FieldT>& poly);
 bool write_polynomial_to_file(const std::string& filename, const std::vector<FieldT>& poly);
 bool write_polynomial(const std::string& filename, const std::vector<FieldT>& poly);
+bool same_polynomial_file(const std::string& filename_a, const std::string& filename_b);
 
 void generate_polynomial_to_file(const std::string& filename, size_t degree);
 
+size_t polynomial_file_size(const std::string& filename);
+
+/* Resident set size in kB: current (procps) and the process peak so far (getrusage) */
+struct memory_usage
+{
+    size_t rss_kb;
+    size_t peak_kb;
+};
+
+memory_usage get_memory_usage();
+size_t get_available_memory_kb();
+
+/* Per-phase memory report: checkpoints are recorded only once it is enabled */
+void enable_memory_report();
+void memory_checkpoint(const std::string& phase);
+void print_memory_report();
+
 #endif // FFT_OPERATIONS_HPP
\ No newline at end of file
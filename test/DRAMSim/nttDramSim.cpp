@@ -0,0 +1,294 @@
+#include <algorithm>
+#include <deque>
+#include <memory>
+#include <regex>
+#include <sstream>
+#include <unordered_map>
+
+#include "dramsim3.h"
+
+#include "utils.hpp"
+#include "ntt_access.hpp"
+#include "cache_sim.hpp"
+
+/*
+ * In-process DRAMSim3 co-simulation of the NTT address streams (ntt_access.hpp).
+ *
+ * The stream goes through the cache hierarchy of cache_sim.hpp (or straight
+ * to DRAM with -C none), and its last-level misses and writebacks are issued
+ * to a DRAMSim3 MemorySystem while the stream is generated, so nothing is
+ * buffered and a whole transform runs to completion. At most `outstanding`
+ * reads are in flight (the core's MSHRs / memory-level parallelism); a read
+ * that finds them all busy stalls the stream until one returns. The stream
+ * is paced in DRAM cycles: `gap` per line access and `compute` per butterfly.
+ *
+ * Reported per configuration and kernel: DRAM cycles to drain the stream,
+ * achieved bandwidth, row-buffer hit rate (from DRAMSim3's own statistics)
+ * and the read latency distribution measured at the callbacks.
+ */
+
+struct dram_run_stats
+{
+    uint64_t cycles = 0;
+    size_t reads = 0;
+    size_t writes = 0;
+    size_t stalls = 0;                  // cycles spent waiting for a free read slot
+    std::vector<uint64_t> latencies;    // read latencies, DRAM cycles
+};
+
+class dram_cosim
+{
+public:
+    dram_cosim(const std::string& config, const std::string& output_dir, const size_t outstanding)
+        : outstanding(outstanding)
+    {
+        memory.reset(dramsim3::GetMemorySystem(config, output_dir,
+            [this](uint64_t addr) { read_done(addr); },
+            [this](uint64_t) { --writes_in_flight; }));
+    }
+
+    /* Stream time, in DRAM cycles, before which the next request cannot issue */
+    void advance(const uint64_t cycles) { ready += cycles; }
+
+    /* cache_hierarchy memory callback: issue one transaction, ticking DRAM until it is accepted */
+    void operator()(const uint64_t addr, const bool write)
+    {
+        while (clock < ready) tick();
+        while ((!write && reads_in_flight >= outstanding) || !memory->WillAcceptTransaction(addr, write)) {
+            tick();
+            ++stats.stalls;
+        }
+        memory->AddTransaction(addr, write);
+        if (write) {
+            ++writes_in_flight;
+            ++stats.writes;
+        } else {
+            ++reads_in_flight;
+            ++stats.reads;
+            issued[addr].push_back(clock);
+        }
+        /* The stream does not run ahead of a stall */
+        ready = std::max(ready, clock);
+    }
+
+    /* Ticks until every transaction has completed */
+    dram_run_stats finish()
+    {
+        while (reads_in_flight || writes_in_flight) tick();
+        stats.cycles = clock;
+        memory->PrintStats();
+        return stats;
+    }
+
+    double tck() const { return memory->GetTCK(); }
+    size_t transaction_bytes() const { return memory->GetBusBits() / 8 * memory->GetBurstLength(); }
+
+private:
+    std::unique_ptr<dramsim3::MemorySystem> memory;
+    size_t outstanding;
+    uint64_t clock = 0;
+    uint64_t ready = 0;
+    size_t reads_in_flight = 0;
+    size_t writes_in_flight = 0;
+    std::unordered_map<uint64_t, std::deque<uint64_t>> issued;
+    dram_run_stats stats;
+
+    void tick()
+    {
+        memory->ClockTick();
+        ++clock;
+    }
+
+    void read_done(const uint64_t addr)
+    {
+        auto it = issued.find(addr);
+        if (it == issued.end()) return;
+        stats.latencies.push_back(clock - it->second.front());
+        it->second.pop_front();
+        if (it->second.empty()) issued.erase(it);
+        --reads_in_flight;
+    }
+};
+
+/* ntt_access_stream sink: line accesses through the caches (if any) into the co-simulation */
+class cosim_sink
+{
+public:
+    size_t element = 32;
+    size_t gap = 1;
+    size_t compute_cycles = 0;
+
+    cosim_sink(dram_cosim& dram, cache_hierarchy* caches, const size_t line) : dram(dram), caches(caches), line(line) {}
+
+    bool stage(const std::string&) { return true; }
+
+    void thread(const size_t t) { current = t; }
+
+    void access(const uint64_t addr, const bool write)
+    {
+        for (uint64_t l = addr / line; l <= (addr + element - 1) / line; ++l) {
+            dram.advance(gap);
+            if (caches) caches->access(current, l * line, write, dram);
+            else dram(l * line, write);
+        }
+    }
+
+    void compute() { dram.advance(compute_cycles); }
+
+    bool done() const { return false; }
+
+private:
+    dram_cosim& dram;
+    cache_hierarchy* caches;
+    size_t line;
+    size_t current = 0;
+};
+
+/* Sum of "key":value over the channels of DRAMSim3's JSON statistics */
+uint64_t dramsim_stat(const std::string& json, const std::string& key)
+{
+    const std::regex pattern("\"" + key + "\":([0-9]+)");
+    uint64_t sum = 0;
+    for (auto it = std::sregex_iterator(json.begin(), json.end(), pattern); it != std::sregex_iterator(); ++it)
+        sum += std::stoull((*it)[1].str());
+    return sum;
+}
+
+uint64_t latency_percentile(const std::vector<uint64_t>& sorted, const double p)
+{
+    if (sorted.empty()) return 0;
+    return sorted[std::min(sorted.size() - 1, static_cast<size_t>(p * sorted.size()))];
+}
+
+int main(int argc, char* argv[]) {
+    int opt;
+    ntt_access_params params;
+    params.log_n = 16;
+    std::vector<ntt_access_kernel> kernels;
+    std::vector<std::string> configs;
+    std::string spec = "L1:32K:8,L2:1M:16,LLC:32M:16";
+    std::string output_dir = ".";
+    size_t line = 64;
+    size_t outstanding = 16;
+    size_t gap = 1;
+    size_t compute_cycles = 0;
+
+    while ((opt = getopt(argc, argv, "k:d:n:t:l:E:A:C:L:q:g:m:o:")) != -1) {
+        switch (opt) {
+            case 'k':
+                if (!parse_ntt_access_kernel(optarg, params.kernel)) {
+                    std::cerr << "[-] Unknown kernel " << optarg << " (serial|four_step|stockham|radix2)" << std::endl;
+                    return 1;
+                }
+                kernels.push_back(params.kernel);
+                break;
+            case 'd':
+                configs.push_back(optarg);
+                break;
+            case 'n':
+                params.log_n = std::stoul(optarg);
+                break;
+            case 't':
+                params.threads = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'l':
+                params.lanes = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'E':
+                params.element = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'A':
+                params.base = std::stoull(optarg, nullptr, 0);
+                break;
+            case 'C':
+                spec = optarg;
+                break;
+            case 'L':
+                line = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'q':
+                outstanding = std::max(1ul, std::stoul(optarg));
+                break;
+            case 'g':
+                gap = std::stoul(optarg);
+                break;
+            case 'm':
+                compute_cycles = std::stoul(optarg);
+                break;
+            case 'o':
+                output_dir = optarg;
+                break;
+            default:
+                std::cerr << "Usage: " << argv[0] << " [-k kernel]... [-d dramsim3_config]... [-n k] [-t threads] [-l lanes] [-E element_bytes]"
+                          << " [-A base] [-C name:size:ways,...|none] [-L line_bytes] [-q outstanding_reads] [-g gap] [-m compute_cycles] [-o output_dir]" << std::endl;
+                return 1;
+        }
+    }
+    if (kernels.empty())
+        kernels = {ntt_access_kernel::serial, ntt_access_kernel::four_step, ntt_access_kernel::stockham, ntt_access_kernel::radix2};
+    if (configs.empty())
+        configs = {"../test/DRAMSim/configs/DDR4_4Gb_x16_2666.ini", "../test/DRAMSim/configs/HBM2_8Gb_x128.ini"};
+
+    std::vector<cache_level_config> levels;
+    if (spec != "none" && !parse_cache_levels(spec, levels)) {
+        std::cerr << "[-] Invalid cache levels " << spec << " (expected name:size:ways,... or none)" << std::endl;
+        return 1;
+    }
+
+    std::cout << "[*] Caches " << spec << ", " << line << " byte lines, " << outstanding << " outstanding reads" << std::endl;
+    for (const std::string& config : configs) {
+        if (!std::ifstream(config).good()) {
+            std::cerr << "[-] Unable to open file " << config << std::endl;
+            return 1;
+        }
+        std::cout << "[*] " << config.substr(config.find_last_of('/') + 1) << std::endl;
+
+        for (const ntt_access_kernel kernel : kernels) {
+            params.kernel = kernel;
+            std::unique_ptr<cache_hierarchy> caches;
+            try {
+                if (!levels.empty()) caches.reset(new cache_hierarchy(levels, line, params.threads));
+            } catch (const InvalidSizeException& e) {
+                std::cerr << "[-] " << e.what() << std::endl;
+                return 1;
+            }
+
+            dram_cosim dram(config, output_dir, outstanding);
+            cosim_sink sink(dram, caches.get(), line);
+            sink.element = params.element;
+            sink.gap = gap;
+            sink.compute_cycles = compute_cycles;
+            ntt_access_stream(params, sink);
+            dram_run_stats s = dram.finish();
+
+            std::ifstream json_file(output_dir + "/dramsim3.json");
+            std::stringstream json;
+            json << json_file.rdbuf();
+            const uint64_t row_hits = dramsim_stat(json.str(), "num_read_row_hits") + dramsim_stat(json.str(), "num_write_row_hits");
+            const uint64_t commands = dramsim_stat(json.str(), "num_read_cmds") + dramsim_stat(json.str(), "num_write_cmds");
+
+            std::sort(s.latencies.begin(), s.latencies.end());
+            double mean = 0;
+            for (const uint64_t l : s.latencies) mean += l;
+            if (!s.latencies.empty()) mean /= s.latencies.size();
+
+            const double ns = s.cycles * dram.tck();
+            const double bytes = static_cast<double>(s.reads + s.writes) * dram.transaction_bytes();
+
+            std::cout << "[i] " << ntt_access_kernel_name(kernel) << " 2^" << params.log_n << " x" << params.threads
+                      << " : " << s.reads << " reads, " << s.writes << " writes" << std::endl;
+            std::cout << std::fixed << std::setprecision(2);
+            std::cout << "\t - " << std::setw(_print_align - 8) << std::left << "DRAM cycles" << std::right
+                      << std::setw(14) << s.cycles << " (" << ns / 1e3 << " us, " << s.stalls << " stalled issue cycles)" << std::endl;
+            std::cout << "\t - " << std::setw(_print_align - 8) << std::left << "Bandwidth" << std::right
+                      << std::setw(14) << (ns > 0 ? bytes / ns : 0.0) << " GB/s" << std::endl;
+            std::cout << "\t - " << std::setw(_print_align - 8) << std::left << "Row buffer hit rate" << std::right
+                      << std::setw(14) << (commands ? 100.0 * row_hits / commands : 0.0) << " %" << std::endl;
+            std::cout << "\t - " << std::setw(_print_align - 8) << std::left << "Read latency (cycles)" << std::right
+                      << std::setw(14) << mean << " mean, p50 " << latency_percentile(s.latencies, 0.50)
+                      << ", p90 " << latency_percentile(s.latencies, 0.90) << ", p99 " << latency_percentile(s.latencies, 0.99)
+                      << ", max " << (s.latencies.empty() ? 0 : s.latencies.back()) << std::endl;
+        }
+    }
+    return 0;
+}